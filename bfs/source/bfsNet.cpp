@@ -10,18 +10,81 @@
 *      and record highest weight from the duplicates.
 *      Sharlee Climer, July 2009
 *
+*      Edges are collected, then sorted into adjacency arrays.
+*      October 2026
+*
+*      .gml files are mapped into memory and read in one pass.
+*      October 2026
+*
+*      Networks can be saved to and mapped from graph files.
+*      October 2026
+*
+*      Core numbers and maximal cliques of large components.
+*      October 2026
+*
+*      Communities of large components.
+*      October 2026
+*
 ****************************************************************************/
   
 
 #include "bfsNet.h"
 #include "network.h"
+#include "gmlscan.h"
 
 using namespace std;
 
 int main(int argc, char ** argv)
 {
-  if (argc != 3)
-    fatal("Usage:\n  bfs input.gml output.bfs"); 
+  if (argc < 3)
+    fatal("Usage:\n  bfs input.gml output.bfs [--save graph.bbg] [--twonode] [--dendrogram merges.txt [--cut threshold]...] [--cores cores.txt [--min-size n] [--cliques seconds]] [--communities refined.bfs [--split-size n]]"); 
+
+  char *saveName = NULL; // graph file to write, if any
+  int twoNode = -1; // 1 if nodes are allele pairs of a TWONODE network, -1 if not known
+  char *dendName = NULL; // dendrogram file to write, if any
+  int numCuts = 0; // number of thresholds to cut dendrogram at
+  double *cut; // thresholds to cut dendrogram at
+  char *coreName = NULL; // core numbers file to write, if any
+  int coreMinSize = CORE_MIN_SIZE; // smallest component given core numbers
+  double cliqueSeconds = 0; // time allowed for listing maximal cliques, 0 for none
+  char *commName = NULL; // clusters with large components split into communities, if any
+  int splitSize = COMMUNITY_MIN_SIZE; // smallest component split into communities
+  if ((cut = new double[argc]) == NULL)
+    fatal("memory not allocated");
+
+  for (int i = 3; i < argc; i++) {
+    if ((strcmp(argv[i], "--save") == 0) && (i+1 < argc))
+      saveName = argv[++i];
+    else if (strcmp(argv[i], "--twonode") == 0)
+      twoNode = 1;
+    else if ((strcmp(argv[i], "--dendrogram") == 0) && (i+1 < argc))
+      dendName = argv[++i];
+    else if ((strcmp(argv[i], "--cut") == 0) && (i+1 < argc))
+      cut[numCuts++] = atof(argv[++i]);
+    else if ((strcmp(argv[i], "--cores") == 0) && (i+1 < argc))
+      coreName = argv[++i];
+    else if ((strcmp(argv[i], "--min-size") == 0) && (i+1 < argc))
+      coreMinSize = atoi(argv[++i]);
+    else if ((strcmp(argv[i], "--cliques") == 0) && (i+1 < argc))
+      cliqueSeconds = atof(argv[++i]);
+    else if ((strcmp(argv[i], "--communities") == 0) && (i+1 < argc))
+      commName = argv[++i];
+    else if ((strcmp(argv[i], "--split-size") == 0) && (i+1 < argc))
+      splitSize = atoi(argv[++i]);
+    else
+      fatal("Usage:\n  bfs input.gml output.bfs [--save graph.bbg] [--twonode] [--dendrogram merges.txt [--cut threshold]...] [--cores cores.txt [--min-size n] [--cliques seconds]] [--communities refined.bfs [--split-size n]]"); 
+  }
+
+  if ((numCuts > 0) && (dendName == NULL))
+    fatal("--cut needs a dendrogram file (--dendrogram)");
+  if ((coreName == NULL) && ((coreMinSize != CORE_MIN_SIZE) || (cliqueSeconds > 0)))
+    fatal("--min-size and --cliques need a cores file (--cores)");
+  if (coreMinSize < 1)
+    fatal("--min-size must be at least 1");
+  if ((commName == NULL) && (splitSize != COMMUNITY_MIN_SIZE))
+    fatal("--split-size needs a communities file (--communities)");
+  if (splitSize < 1)
+    fatal("--split-size must be at least 1");
 
   FILE *input;
   FILE *output;
@@ -33,7 +96,7 @@ int main(int argc, char ** argv)
   if(testFile != 0)
 	fatal("Component files already exist in this directory");
   
-  if (((input = fopen(argv[1], "r")) == NULL) || ((output = fopen(argv[2], "w"))
+  if (((input = fopen(argv[1], "rb")) == NULL) || ((output = fopen(argv[2], "w"))
  == NULL))
     fatal("File could not be opened.\n");
 
@@ -42,38 +105,53 @@ int main(int argc, char ** argv)
 
   int min = 1000000000;   // hold min node number
   int max = -1000000000;  // hold max node number
-  char string[50];
   int startOne; // 1 if start node number is 1, 0 if start number is 0
 
-  while (1) { // throw away everything until get to "graph" declaration
-    if(feof(input)) fatal("no graph to read in input file");
+  GraphFile graph; // CSR arrays written by 'bfs --save', used in place
+  int mappedGraph = mapGraph(&graph, input); // 1 if input is a graph file
 
-    fscanf(input, "%s", string); // read in string from file
+  if (mappedGraph < 0)
+    fatal("Graph file is damaged");
+  if (mappedGraph && (twoNode < 0))
+    twoNode = graph.twoNode; // as recorded when it was saved
 
-    if(strncmp(string, "graph", 5) == 0) 
-      break; // stop when get to "graph" declaration
-  }
+  int binNodes; // number of nodes in header of binary edge file
+  int binary = !mappedGraph && readBinaryHead(input, &binNodes); // 1 if written by 'ccc --binary'
+  int frameBinary; // 1 if frames hold binary records
+  int framed = !mappedGraph && !binary && readFrameHead(input, &binNodes, &frameBinary); // 1 if written by 'ccc --framed'
 
-  // find number of nodes in graph
-  int numNodes = 0; // number of nodes
-  int numEdges = 0; // number of edges
+  FramedEdge *framedEdge = NULL; // edges of framed file, decompressed in parallel
+  long int numFramed = 0; // number of edges in framed file
 
-  while (1) { // throw away everything until get to "edge" declaration
-    if(feof(input)) fatal("no edges to read in input file");
+  if (framed && ((numFramed = readFramedEdges(input, &framedEdge)) < 0))
+    fatal("Framed input file is damaged");
 
-    fscanf(input, "%s", string); // read in string from file
+  int headerNodes = binary || framed || mappedGraph; // 1 if the file gives the number of nodes instead of a node list (Boolean)
 
-    if(strncmp(string, "id", 2) == 0) { 
-      fscanf(input, "%s", string); // read in id value
-      int num = atoi(string);
+  GmlScanner gml; // .gml file mapped into memory, read in one pass
+  if (!headerNodes && !openGml(&gml, input))
+    fatal(gml.error);
 
-      if(min > num) min = num; // update minimum node number
-      if(max < num) max = num; // update maximum node number
-      numNodes++; // one more node found
-    }
+  // find number of nodes in graph
+  int numNodes = 0; // number of nodes
+  int numEdges = 0; // number of edges
 
-    if(strncmp(string, "edge", 4) == 0) 
-      break; // stop when read in first "edge"
+  if (mappedGraph) { // node ids are stored with the arrays
+    numNodes = graph.numNodes;
+    for (int i = 0; i < numNodes; i++) {
+      if(min > graph.id[i]) min = graph.id[i]; // update minimum node number
+      if(max < graph.id[i]) max = graph.id[i]; // update maximum node number
+    }
+  }
+  else if (headerNodes) { // nodes are numbered from 1
+    min = 1;
+    max = binNodes;
+    numNodes = binNodes;
+  }
+  else {
+    min = gml.minId;
+    max = gml.maxId;
+    numNodes = gml.numNodes;
   }
 
   cout << "\nNode numbers range from " << min <<" to " << max << endl
@@ -85,7 +163,6 @@ int main(int argc, char ** argv)
   fclose(output); 
 
   startOne = min;
-  rewind(input); // start at beginning of input file again
 
   if(startOne < 0) fatal("Node numbers can not be negative");
   if ((startOne != 0) && (startOne != 1)) 
@@ -97,34 +174,15 @@ int main(int argc, char ** argv)
   if ((id = new int[numNodes]) == NULL)
     fatal("memory not allocated");
 
-  while (1) { // throw away everything until get to "graph" declaration
-    if(feof(input)) fatal("no graph to read in input file");
+  if (mappedGraph)
+    for (ptr = 0; ptr < numNodes; ptr++)
+      id[ptr] = graph.id[ptr];
+  else if (headerNodes) // binary and framed edge files have no node list
+    for (ptr = 0; ptr < numNodes; ptr++)
+      id[ptr] = ptr + 1;
 
-    fscanf(input, "%s", string); // read in string from file
-
-    if(strncmp(string, "graph", 5) == 0) 
-      break; // stop when get to "graph" declaration
-  }
-
-  while (1) { // record node id numbers 
-    if(feof(input)) fatal("no edges to read in input file");
-
-    fscanf(input, "%s", string); // read in string from file
-  
-    if(strncmp(string, "id", 2) == 0) { 
-      fscanf(input, "%s", string); // read in id value
-      int num = atoi(string);
-
-      if((num < min) || (num > max))
-	fatal("error while reading in node numbers");
-
-      id[ptr++] = num; // record node id number
-      //cout << ptr << ", " << id[ptr-1]<< endl;
-    }
-
-    if(strncmp(string, "edge", 4) == 0) 
-      break; // stop when read in first "edge"
-  }
+  for (int i = 0; !headerNodes && (i < numNodes); i++) // node ids as declared in .gml file
+    id[ptr++] = gml.id[i];
 
   if (ptr != numNodes)
     fatal("Error reading in node numbers");
@@ -152,83 +210,102 @@ int main(int argc, char ** argv)
   }
 
   // create network with numNodes vertices
-  Network sparseNet(numNodes, DIRECTED); // if DIRECTED = 0, undirected
+  // if DIRECTED = 0, undirected; (j,i) entries and weights are only kept
+  // when they are needed for component output files or a graph file
+  Network sparseNet(numNodes, DIRECTED, RETAINSYMMETRIC || BFS_WG2, BFS_GML || (saveName != NULL) || (dendName != NULL) || (commName != NULL));
   int dupEdges = 0; // record number of duplicate edges
 
-  while (!feof(input)) { // read edges until reach end of file
-    fscanf(input, "%s", string); // read in string from file
-
-    if(!strncmp(string, "[", 1) == 0) // check for correct character
-      fatal("No '[' after edge declaration");
+  int binSource, binTarget; // endpoints of edge in binary file
+  unsigned short binWeight; // quantised weight of edge in binary file
 
-    fscanf(input, "%s", string); // read in string from file
-    if(!strncmp(string, "source", 6) == 0) // check for correct character
-      fatal("No 'source' declaration");
+  if (mappedGraph && !(RETAINSYMMETRIC || BFS_WG2)) { // components are found on the mapped arrays
+    sparseNet.mapEdges(&graph);
+    numEdges = (int)graph.numEdges;
+  }
 
-    fscanf(input, "%s", string); // read in start node from file
-    int source = atoi(string);
+  for (int i = 0; mappedGraph && (RETAINSYMMETRIC || BFS_WG2) && (i < numNodes); i++)
+    for (long int e = graph.offset[i]; e < graph.offset[i+1]; e++) { // (j,i) entries must be built
+      sparseNet.addEdge(i, graph.target[e], weightValue(graph.weight[e]));
+      numEdges++;
+    }
 
-    if((source < min) || (source > max))
+  while (binary && readBinaryEdge(input, &binSource, &binTarget, &binWeight)) {
+    if((binSource < min) || (binSource > max) || (binTarget < min) || (binTarget > max))
       fatal("Invalid node number");
 
-    //cout << "source: " << idInv[source];
-
-    fscanf(input, "%s", string); // read in string from file
-    if(!strncmp(string, "target", 6) == 0) // check for correct character
-      fatal("No 'target' declaration");
+    if(!sparseNet.addEdge(idInv[binSource],idInv[binTarget],weightValue(binWeight)))
+      dupEdges++;
+    else
+      numEdges++; // count number of edges
 
-    fscanf(input, "%s", string); // read in target node from file
-    int target = atoi(string);
+    if(numEdges % 10000000 == 0) // message every 10 million edges
+      cout << numEdges / 1000000 << " million edges read" << endl;
+  }
 
-    if((target < min) || (target > max))
+  for (long int e = 0; e < numFramed; e++) {
+    if((framedEdge[e].source < min) || (framedEdge[e].source > max) || (framedEdge[e].target < min) || (framedEdge[e].target > max))
       fatal("Invalid node number");
 
-    //cout << ", target: " << idInv[target];
-
-    fscanf(input, "%s", string); // read in string from file
-
-    float weight = 1.0;
-    if(strncmp(string, "weight", 6) == 0) {// check to see if weight specified
-      fscanf(input, "%s", string); // read in string from file
-      weight = atof(string);
-      fscanf(input, "%s", string); // read in string from file
-    }
-
-    //cout << ", weight: " << weight << endl;
-    
-    if(!sparseNet.addEdge(idInv[source],idInv[target],weight))
-	  dupEdges++;
-      //warning("Duplicate edge in input");
-    
+    if(!sparseNet.addEdge(idInv[framedEdge[e].source],idInv[framedEdge[e].target],framedEdge[e].weight))
+      dupEdges++;
     else
       numEdges++; // count number of edges
 
-	if(numEdges % 10000000 == 0) // message every 10 million edges
-	  cout << numEdges / 1000000 << " million edges read" << endl;
-
-    if(!strncmp(string, "]", 1) == 0) // check for correct character
-      fatal("No ']' after edge declaration");
+    if(numEdges % 10000000 == 0) // message every 10 million edges
+      cout << numEdges / 1000000 << " million edges read" << endl;
+  }
 
-    //fprintf(output, "%d\t%d\t%f\n", source, target, weight);
+  int source, target; // endpoints of edge in .gml file
+  float weight; // weight of edge, 1.0 if not given
+  int hasWeight; // 1 if weight given (Boolean)
+  int found; // 1 if edge read, 0 at end of graph, -1 on error
 
-    if (feof(input)) break; // break is at end of file
+  while (!headerNodes && ((found = nextGmlEdge(&gml, &source, &target, &weight, &hasWeight)) != 0)) {
+    if (found < 0)
+      fatal(gml.error);
 
-    fscanf(input, "%s", string); // read in string from file
+    if((source < min) || (source > max) || (target < min) || (target > max))
+      fatal("Invalid node number");
 
-    if(strncmp(string, "]", 1) == 0) // check for end of graph
-      break;
+    if(!sparseNet.addEdge(idInv[source],idInv[target],weight))
+      dupEdges++;
+    else
+      numEdges++; // count number of edges
 
-    if(!strncmp(string, "edge", 4) == 0) // check for correct character
-      fatal("No 'edge' declaration");
+    if(numEdges % 10000000 == 0) // message every 10 million edges
+      cout << numEdges / 1000000 << " million edges read" << endl;
   }
 
   //cout << endl;
  
   fclose(input);
+  free(framedEdge); // NULL unless input was framed
+  if (!headerNodes)
+    closeGml(&gml);
+
+  // sort edges into adjacency arrays, dropping duplicates
+  int numDup = sparseNet.finishEdges();
+  dupEdges += numDup;
+  numEdges -= numDup;
 
   if (sparseNet.getNumEdges() != numEdges)
     fatal("error recording edges in network");
 
+  if (saveName != NULL) {
+    if (!sparseNet.saveGraph(saveName, id, twoNode))
+      fatal("Graph file could not be written");
+    cout << "Network saved to '" << saveName << "'" << endl;
+  }
+
+  if (dendName != NULL) // one pass gives the components at every threshold
+    sparseNet.dendrogram(dendName, cut, numCuts);
+
+  if (coreName != NULL) // dense cores inside large components
+    sparseNet.cores(coreName, coreMinSize, cliqueSeconds);
+
+  if (commName != NULL) // giant components broken into blocs
+    sparseNet.communities(commName, splitSize);
+
   cout << "\nFinding components and printing them to compX.gml files...\n" << endl;
 
   sparseNet.bfs(argv[2]);
@@ -248,6 +325,9 @@ int main(int argc, char ** argv)
 
   delete [] id;
   delete [] idInv;
+  delete [] cut;
+  if (mappedGraph)
+    unmapGraph(&graph);
 
   return 1;
 }
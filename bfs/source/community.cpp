@@ -0,0 +1,351 @@
+/****************************************************************************
+*
+*	community.cpp:	Louvain communities of weighted networks given
+*                       as CSR arrays (see community.h).
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include "community.h"
+#include "bfsNet.h"
+#include <algorithm>
+#include <vector>
+
+
+struct Level // network at one level of aggregation
+{
+  int n; // number of vertices
+  long int *offset; // CSR rows
+  int *adj;
+  double *wt; // weight of each entry (self-loops hold weight inside)
+  int *group; // group of each vertex
+};
+
+
+int batchOf(int v, int sweep) // batch of v in given sweep, mixed so batches differ each sweep
+{
+  unsigned int h = ((unsigned int)v ^ ((unsigned int)sweep * 0x9e3779b9U)) * 2654435761U;
+  return (int)((h >> 16) % LOUVAIN_BATCHES);
+}
+
+
+struct Tally // weight from a vertex to each neighbouring community, in an open addressing table
+{
+  std::vector<int> key; // community in each slot, -1 if empty
+  std::vector<double> sum; // weight to community in each slot
+  std::vector<int> used; // slots filled, in order
+};
+
+
+// neighbouring community of v that raises modularity most, given the
+// community and total strength of each community before this batch
+int bestCommunity(Level *g, int v, const int *comm, const double *tot, const int *size, const double *strength, const double *groupTotal, Tally *t)
+{
+  int c = comm[v];
+  double kv = strength[v];
+  double m2 = groupTotal[g->group[v]]; // twice the weight of the group
+  long int deg = g->offset[v+1] - g->offset[v];
+  if ((deg == 0) || (m2 <= 0))
+    return c;
+
+  size_t cap = 16; // table at most half full
+  while (cap < 2 * (size_t)deg)
+    cap *= 2;
+  if (t->key.size() < cap) {
+    t->key.assign(cap, -1);
+    t->sum.resize(cap);
+  }
+
+  t->used.clear();
+  for (long int e = g->offset[v]; e < g->offset[v+1]; e++) {
+    if (g->adj[e] == v)
+      continue; // weight inside v itself
+    int d = comm[g->adj[e]];
+    size_t h = ((unsigned int)d * 2654435761U) & (cap - 1);
+    while ((t->key[h] != -1) && (t->key[h] != d))
+      h = (h + 1) & (cap - 1);
+    if (t->key[h] == -1) {
+      t->key[h] = d;
+      t->sum[h] = 0;
+      t->used.push_back((int)h);
+    }
+    t->sum[h] += g->wt[e];
+  }
+
+  double kvc = 0; // weight from v to the rest of its own community
+  for (size_t i = 0; i < t->used.size(); i++)
+    if (t->key[t->used[i]] == c)
+      kvc = t->sum[t->used[i]];
+
+  int best = c;
+  double bestScore = kvc - RESOLUTION * kv * (tot[c] - kv) / m2; // staying
+  for (size_t i = 0; i < t->used.size(); i++) {
+    int d = t->key[t->used[i]];
+    if (d == c)
+      continue;
+    double score = t->sum[t->used[i]] - RESOLUTION * kv * tot[d] / m2;
+    if ((score > bestScore + 1e-12) || ((best != c) && (d < best) && (score > bestScore - 1e-12))) {
+      bestScore = score; // lowest community wins ties, except with staying
+      best = d;
+    }
+  }
+
+  for (size_t i = 0; i < t->used.size(); i++) // empty the table for the next vertex
+    t->key[t->used[i]] = -1;
+
+  if ((best != c) && (size[c] == 1) && (size[best] == 1) && (best > c))
+    return c; // two lone vertices would swap; only the higher one moves
+
+  return best;
+}
+
+
+// move vertices between communities until no move raises modularity,
+// set comm[v] to the new number of the community of v (from 0), return
+// number of communities
+int localMoves(Level *g, const double *groupTotal, int *comm)
+{
+  double *strength, *tot; // weight of edges of each vertex, and of each community
+  int *size, *target; // vertices in each community, and community chosen for each vertex
+  if (((strength = new double[g->n]) == NULL) || ((tot = new double[g->n]) == NULL) || ((size = new int[g->n]) == NULL) || ((target = new int[g->n]) == NULL))
+    fatal("memory not allocated");
+
+  #pragma omp parallel for
+  for (int v = 0; v < g->n; v++) {
+    strength[v] = 0;
+    for (long int e = g->offset[v]; e < g->offset[v+1]; e++)
+      strength[v] += g->wt[e];
+    comm[v] = v; // each vertex on its own
+    tot[v] = strength[v];
+    size[v] = 1;
+  }
+
+  for (int sweep = 0; sweep < LOUVAIN_SWEEPS; sweep++) {
+    long int moved = 0;
+
+    for (int b = 0; b < LOUVAIN_BATCHES; b++) {
+      #pragma omp parallel
+      {
+	Tally t; // weights to neighbouring communities
+	#pragma omp for schedule(dynamic, 256)
+	for (int v = 0; v < g->n; v++)
+	  if (batchOf(v, sweep) == b)
+	    target[v] = bestCommunity(g, v, comm, tot, size, strength, groupTotal, &t);
+      }
+
+      for (int v = 0; v < g->n; v++) // apply in order, so sums don't depend on threads
+	if ((batchOf(v, sweep) == b) && (target[v] != comm[v])) {
+	  tot[comm[v]] -= strength[v];
+	  size[comm[v]]--;
+	  comm[v] = target[v];
+	  tot[comm[v]] += strength[v];
+	  size[comm[v]]++;
+	  moved++;
+	}
+    }
+
+    if (moved <= LOUVAIN_SETTLED * g->n)
+      break; // few vertices still moving
+  }
+
+  // number the communities from 0, in order of their old numbers
+  int numComm = 0;
+  for (int c = 0; c < g->n; c++)
+    target[c] = (size[c] > 0) ? numComm++ : -1;
+  for (int v = 0; v < g->n; v++)
+    comm[v] = target[comm[v]];
+
+  delete [] strength;
+  delete [] tot;
+  delete [] size;
+  delete [] target;
+  return numComm;
+}
+
+
+// fill row of community c of coarse network from rows of its members,
+// merging entries to the same community; return length of row
+long int coarseRow(Level *g, const int *comm, const int *member, int numMembers, int *adj, double *wt, std::vector< std::pair<int, double> > &buf)
+{
+  buf.clear();
+  for (int m = 0; m < numMembers; m++)
+    for (long int e = g->offset[member[m]]; e < g->offset[member[m]+1]; e++)
+      buf.push_back(std::make_pair(comm[g->adj[e]], g->wt[e]));
+  std::sort(buf.begin(), buf.end());
+
+  long int len = 0;
+  for (size_t i = 0; i < buf.size(); len++) {
+    int d = buf[i].first;
+    double w = 0;
+    for ( ; (i < buf.size()) && (buf[i].first == d); i++)
+      w += buf[i].second;
+    if (adj != NULL) {
+      adj[len] = d;
+      wt[len] = w;
+    }
+  }
+  return len;
+}
+
+
+// network with a vertex for each community of g
+Level aggregate(Level *g, const int *comm, int numComm)
+{
+  Level h;
+  int *first, *member; // members of each community
+  h.n = numComm;
+  if (((first = new int[numComm+1]) == NULL) || ((member = new int[g->n]) == NULL) || ((h.offset = new long int[numComm+1]) == NULL) || ((h.group = new int[numComm]) == NULL))
+    fatal("memory not allocated");
+
+  for (int c = 0; c <= numComm; c++)
+    first[c] = 0;
+  for (int v = 0; v < g->n; v++)
+    first[comm[v]+1]++;
+  for (int c = 0; c < numComm; c++)
+    first[c+1] += first[c];
+  for (int v = 0; v < g->n; v++) { // first[c] is moved on to the next community
+    member[first[comm[v]]++] = v;
+    h.group[comm[v]] = g->group[v];
+  }
+  for (int c = numComm; c > 0; c--)
+    first[c] = first[c-1];
+  first[0] = 0;
+
+  // count entries of each row, then fill them
+  h.offset[0] = 0;
+  #pragma omp parallel
+  {
+    std::vector< std::pair<int, double> > buf;
+    #pragma omp for schedule(dynamic, 64)
+    for (int c = 0; c < numComm; c++)
+      h.offset[c+1] = coarseRow(g, comm, member + first[c], first[c+1] - first[c], NULL, NULL, buf);
+  }
+  for (int c = 0; c < numComm; c++)
+    h.offset[c+1] += h.offset[c];
+
+  if (((h.adj = new int[h.offset[numComm]]) == NULL) || ((h.wt = new double[h.offset[numComm]]) == NULL))
+    fatal("memory not allocated");
+
+  #pragma omp parallel
+  {
+    std::vector< std::pair<int, double> > buf;
+    #pragma omp for schedule(dynamic, 64)
+    for (int c = 0; c < numComm; c++)
+      coarseRow(g, comm, member + first[c], first[c+1] - first[c], h.adj + h.offset[c], h.wt + h.offset[c], buf);
+  }
+
+  delete [] first;
+  delete [] member;
+  return h;
+}
+
+
+void freeLevel(Level *g)
+{
+  delete [] g->offset;
+  delete [] g->adj;
+  delete [] g->wt;
+  delete [] g->group;
+}
+
+
+void louvain(int numNodes, const long int *offset, const int *adj, const double *wt, const int *group, int numGroups, int *community)
+{
+  double *groupTotal; // twice the weight of edges in each group
+  int *comm; // community of each vertex of current level
+  if (((groupTotal = new double[numGroups]) == NULL) || ((comm = new int[numNodes]) == NULL))
+    fatal("memory not allocated");
+
+  for (int k = 0; k < numGroups; k++)
+    groupTotal[k] = 0;
+  for (int v = 0; v < numNodes; v++)
+    for (long int e = offset[v]; e < offset[v+1]; e++)
+      groupTotal[group[v]] += wt[e];
+
+  Level g; // first level is the network itself
+  g.n = numNodes;
+  g.offset = (long int *)offset;
+  g.adj = (int *)adj;
+  g.wt = (double *)wt;
+  g.group = (int *)group;
+
+  for (int v = 0; v < numNodes; v++)
+    community[v] = v; // vertex of current level holding v
+
+  for (int level = 0; level < LOUVAIN_LEVELS; level++) {
+    int numComm = localMoves(&g, groupTotal, comm);
+    if (numComm == g.n)
+      break; // nothing merged
+
+    #pragma omp parallel for
+    for (int v = 0; v < numNodes; v++)
+      community[v] = comm[community[v]];
+
+    Level h = aggregate(&g, comm, numComm);
+    if (level > 0)
+      freeLevel(&g);
+    g = h;
+  }
+  if (g.offset != offset)
+    freeLevel(&g);
+
+  // split communities into connected parts; the lowest vertex of each
+  // part is its root
+  int *root = comm; // reused as union-find parent
+  for (int v = 0; v < numNodes; v++)
+    root[v] = v;
+  for (int v = 0; v < numNodes; v++)
+    for (long int e = offset[v]; e < offset[v+1]; e++) {
+      int u = adj[e];
+      if ((u >= v) || (community[u] != community[v]))
+	continue; // each edge once, and only inside a community
+      int r1 = v, r2 = u;
+      while (root[r1] != r1)
+	r1 = root[r1] = root[root[r1]]; // path halving
+      while (root[r2] != r2)
+	r2 = root[r2] = root[root[r2]];
+      if (r1 > r2)
+	std::swap(r1, r2);
+      root[r2] = r1; // lower root wins
+    }
+  for (int v = 0; v < numNodes; v++) {
+    int r = v;
+    while (root[r] != r)
+      r = root[r];
+    community[v] = r;
+  }
+
+  delete [] groupTotal;
+  delete [] comm;
+}
+
+
+void groupModularity(int numNodes, const long int *offset, const int *adj, const double *wt, const int *group, int numGroups, const int *community, double *modularity)
+{
+  double *groupTotal, *inside, *tot; // twice the weight of each group, weight inside each community and of its edges
+  if (((groupTotal = new double[numGroups]) == NULL) || ((inside = new double[numNodes]) == NULL) || ((tot = new double[numNodes]) == NULL))
+    fatal("memory not allocated");
+
+  for (int k = 0; k < numGroups; k++)
+    groupTotal[k] = modularity[k] = 0;
+  for (int v = 0; v < numNodes; v++)
+    inside[v] = tot[v] = 0;
+
+  for (int v = 0; v < numNodes; v++)
+    for (long int e = offset[v]; e < offset[v+1]; e++) {
+      groupTotal[group[v]] += wt[e];
+      tot[community[v]] += wt[e];
+      if (community[adj[e]] == community[v])
+	inside[community[v]] += wt[e];
+    }
+
+  for (int c = 0; c < numNodes; c++) // communities are numbered by a vertex in them
+    if (groupTotal[group[c]] > 0)
+      modularity[group[c]] += inside[c] / groupTotal[group[c]] - RESOLUTION * (tot[c] / groupTotal[group[c]]) * (tot[c] / groupTotal[group[c]]);
+
+  delete [] groupTotal;
+  delete [] inside;
+  delete [] tot;
+}
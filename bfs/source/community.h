@@ -0,0 +1,39 @@
+// -------------------------------------------------------------------------
+// community.h -   Header file for finding communities in weighted
+//                 networks given as compressed sparse row (CSR) arrays
+//
+// Rows must hold both (i,j) and (j,i) entries.  Vertices are split into
+// groups (the components being refined) that share no edges, and the
+// modularity of each group is that of the group on its own.
+//
+// Communities are found by Louvain: vertices move to the neighbouring
+// community that raises modularity most, then each community becomes a
+// vertex of a smaller network and the moves are repeated, until nothing
+// merges.  Moves are chosen in parallel, a batch of vertices at a time,
+// from the communities as they stood before the batch, and applied
+// between batches, so the communities found don't depend on the number
+// of threads.  As in Leiden, no community is left in pieces: each is
+// finally split into its connected parts.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _COMMUNITY_H
+#define _COMMUNITY_H
+
+const double RESOLUTION = 1.0; // modularity resolution (higher for smaller communities)
+const int LOUVAIN_SWEEPS = 32; // most passes over the vertices at each level
+const int LOUVAIN_BATCHES = 16; // batches of vertices moved at a time in each pass
+const double LOUVAIN_SETTLED = 0.001; // level ends when at most this fraction of vertices moved in a pass
+const int LOUVAIN_LEVELS = 20; // most levels of aggregation
+
+// set community[v] to the lowest vertex of the community of v, for a
+// network with numNodes vertices, CSR rows offset/adj with edge weights
+// wt, and group[v] from 0 to numGroups-1
+void louvain(int numNodes, const long int *offset, const int *adj, const double *wt, const int *group, int numGroups, int *community);
+
+// modularity of each group, given the community of each vertex
+void groupModularity(int numNodes, const long int *offset, const int *adj, const double *wt, const int *group, int numGroups, const int *community, double *modularity);
+
+#endif
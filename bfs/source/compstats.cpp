@@ -0,0 +1,128 @@
+/****************************************************************************
+*
+*	compstats.cpp:	Statistics of component sizes and densities
+*                       (see compstats.h).
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include "compstats.h"
+#include "bfsNet.h"
+#include <algorithm>
+
+
+void startStats(CompStats *cs)
+{
+  cs->num = 0;
+  cs->cap = 1024;
+  cs->min = cs->max = cs->sum = 0;
+  if ((cs->value = (double *)malloc(cs->cap * sizeof(double))) == NULL)
+    fatal("memory not allocated");
+}
+
+
+void addStat(CompStats *cs, double value)
+{
+  if (cs->num == cs->cap) { // double the array
+    cs->cap *= 2;
+    if ((cs->value = (double *)realloc(cs->value, cs->cap * sizeof(double))) == NULL)
+      fatal("memory not allocated");
+  }
+
+  if ((cs->num == 0) || (value < cs->min)) cs->min = value;
+  if ((cs->num == 0) || (value > cs->max)) cs->max = value;
+  cs->sum += value;
+  cs->value[cs->num++] = value;
+}
+
+
+void freeStats(CompStats *cs)
+{
+  free(cs->value);
+  cs->value = NULL;
+  cs->num = cs->cap = 0;
+}
+
+
+double statMean(CompStats *cs)
+{
+  return (cs->num > 0) ? cs->sum / cs->num : 0;
+}
+
+
+double statHalfWidth(CompStats *cs)
+{
+  if (cs->num < 2)
+    return 0;
+
+  double mean = statMean(cs), dev = 0;
+  for (long int i = 0; i < cs->num; i++)
+    dev += (cs->value[i] - mean) * (cs->value[i] - mean);
+  return 2.0 * sqrt(dev / ((double)(cs->num - 1) * cs->num));
+}
+
+
+double statQuantile(CompStats *cs, double q)
+{
+  if (cs->num == 0)
+    return 0;
+
+  double pos = q * (cs->num - 1); // position in sorted order
+  long int low = (long int)pos;
+  if (low >= cs->num - 1)
+    low = cs->num - 1;
+
+  std::nth_element(cs->value, cs->value + low, cs->value + cs->num);
+  double lowValue = cs->value[low];
+  if (low == cs->num - 1)
+    return lowValue;
+
+  // next value in sorted order is the smallest of those after low
+  double highValue = *std::min_element(cs->value + low + 1, cs->value + cs->num);
+  return lowValue + (pos - low) * (highValue - lowValue);
+}
+
+
+double statMedian(CompStats *cs)
+{
+  return statQuantile(cs, 0.5); // middle value, or mean of the two middle values
+}
+
+
+void writeCompStats(FILE *output, CompStats *cs, const char *prefix, int sizes)
+{
+  fprintf(output, "%s_count\t%ld\n", prefix, cs->num);
+  fprintf(output, "%s_min\t%g\n", prefix, cs->min);
+  fprintf(output, "%s_max\t%g\n", prefix, cs->max);
+  fprintf(output, "%s_mean\t%g\n", prefix, statMean(cs));
+  fprintf(output, "%s_ci95_halfwidth\t%g\n", prefix, statHalfWidth(cs));
+
+  for (int q = 0; q < NUM_QUANTILES; q++)
+    fprintf(output, "%s_q%g\t%g\n", prefix, 100 * QUANTILE[q], statQuantile(cs, QUANTILE[q]));
+
+  long int count[SIZE_BINS]; // values in each bin
+  int numBins = sizes ? SIZE_BINS : DENSITY_BINS;
+  for (int b = 0; b < numBins; b++)
+    count[b] = 0;
+
+  for (long int i = 0; i < cs->num; i++) {
+    int b = 0;
+    if (sizes) // bin b holds sizes 2^(b+1) to 2^(b+2)-1
+      for (long int v = (long int)cs->value[i]; v >= 4; v >>= 1)
+	b++;
+    else // density of 1 goes in the last bin
+      b = std::min((int)(cs->value[i] * DENSITY_BINS), DENSITY_BINS - 1);
+    count[std::max(0, std::min(b, numBins - 1))]++;
+  }
+
+  for (int b = 0; b < numBins; b++) {
+    if (sizes && (count[b] == 0))
+      continue; // only bins that occur
+    if (sizes)
+      fprintf(output, "%s_hist_%ld-%ld\t%ld\n", prefix, 2L << b, (4L << b) - 1, count[b]);
+    else
+      fprintf(output, "%s_hist_%.1f-%.1f\t%ld\n", prefix, (double)b / DENSITY_BINS, (double)(b + 1) / DENSITY_BINS, count[b]);
+  }
+}
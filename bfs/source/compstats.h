@@ -0,0 +1,49 @@
+// -------------------------------------------------------------------------
+// compstats.h -   Header file for statistics of component sizes and
+//                 densities
+//
+// Values are added one at a time to an array on the heap that doubles
+// when full, so there is no limit on the number of components.  Medians
+// and quantiles are found by selection (std::nth_element) in time in
+// proportion to the number of values, which reorders the array but
+// doesn't sort it.  Quantiles are exact and interpolated between the two
+// nearest values, as R's default type 7.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _COMPSTATS_H
+#define _COMPSTATS_H
+
+#include <stdio.h>
+
+const int NUM_QUANTILES = 7; // quantiles written to stats file
+const double QUANTILE[NUM_QUANTILES] = {0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99};
+const int DENSITY_BINS = 10; // histogram bins of width 0.1 for densities
+const int SIZE_BINS = 32; // histogram bins for sizes 2-3, 4-7, 8-15, ...
+
+struct CompStats
+{
+  double *value; // values added so far
+  long int num; // number of values
+  long int cap; // values allocated
+  double min, max; // smallest and largest value
+  double sum; // sum of values
+};
+
+void startStats(CompStats *cs); // no values yet
+void addStat(CompStats *cs, double value); // add a value
+void freeStats(CompStats *cs); // release memory
+
+double statMean(CompStats *cs); // mean (0 if no values)
+double statHalfWidth(CompStats *cs); // twice the standard error of the mean
+double statMedian(CompStats *cs); // median (0 if no values)
+double statQuantile(CompStats *cs, double q); // exact q quantile (0 if no values)
+
+// write lines of tab-separated name and value to output, names starting
+// with prefix, ending with a histogram of sizes 2-3, 4-7, 8-15, ... if
+// sizes is 1 or of densities in bins of width 0.1 if it is 0
+void writeCompStats(FILE *output, CompStats *cs, const char *prefix, int sizes);
+
+#endif
@@ -0,0 +1,266 @@
+/****************************************************************************
+*
+*	cores.cpp:	k-cores and maximal cliques of networks given as
+*                       CSR arrays (see cores.h).
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include "cores.h"
+#include "bfsNet.h"
+#include <algorithm>
+#include <omp.h>
+
+
+void coreNumbers(int numNodes, const long int *offset, const int *adj, int *core, int *rank)
+{
+  int *left, *frontier, *next; // vertices not yet peeled, peeled this round, and spare
+  if (((left = (int *)malloc(numNodes * sizeof(int))) == NULL) || ((frontier = (int *)malloc(numNodes * sizeof(int))) == NULL) || ((next = (int *)malloc(numNodes * sizeof(int))) == NULL))
+    fatal("memory not allocated");
+
+  #pragma omp parallel for
+  for (int v = 0; v < numNodes; v++) {
+    core[v] = (int)(offset[v+1] - offset[v]); // degree among vertices left
+    rank[v] = -1; // not peeled yet
+    left[v] = v;
+  }
+
+  int numLeft = numNodes;
+  int round = 0; // peeling rounds so far
+
+  while (numLeft > 0) {
+    // drop vertices peeled at the last k; the lowest degree left is the next k
+    int numKept = 0;
+    int k = numNodes;
+    #pragma omp parallel for reduction(min:k)
+    for (int i = 0; i < numLeft; i++)
+      if (rank[left[i]] < 0) {
+	next[__sync_fetch_and_add(&numKept, 1)] = left[i];
+	k = std::min(k, core[left[i]]);
+      }
+    std::swap(left, next);
+    numLeft = numKept;
+    if (numLeft == 0)
+      break;
+
+    int numFrontier = 0;
+    numKept = 0;
+    #pragma omp parallel for
+    for (int i = 0; i < numLeft; i++)
+      if (core[left[i]] == k)
+	frontier[__sync_fetch_and_add(&numFrontier, 1)] = left[i];
+      else
+	next[__sync_fetch_and_add(&numKept, 1)] = left[i];
+    std::swap(left, next);
+    numLeft = numKept;
+
+    while (numFrontier > 0) { // neighbours brought down to k go in the next round
+      int numNext = 0;
+      #pragma omp parallel for schedule(dynamic, 1024)
+      for (int f = 0; f < numFrontier; f++) {
+	int v = frontier[f];
+	rank[v] = round;
+	for (long int e = offset[v]; e < offset[v+1]; e++) {
+	  int u = adj[e];
+	  if (core[u] > k) {
+	    int d = __sync_fetch_and_sub(&core[u], 1);
+	    if (d == k + 1)
+	      next[__sync_fetch_and_add(&numNext, 1)] = u;
+	    else if (d <= k) // another thread got there first
+	      __sync_fetch_and_add(&core[u], 1);
+	  }
+	}
+      }
+      std::swap(frontier, next);
+      numFrontier = numNext;
+      round++;
+    }
+  }
+
+  free(left);
+  free(frontier);
+  free(next);
+}
+
+
+void startCliques(CliqueList *cl)
+{
+  cl->num = cl->numCliques = 0;
+  cl->cap = 1024;
+  if ((cl->value = (int *)malloc(cl->cap * sizeof(int))) == NULL)
+    fatal("memory not allocated");
+}
+
+
+void freeCliques(CliqueList *cl)
+{
+  free(cl->value);
+  cl->value = NULL;
+  cl->num = cl->cap = cl->numCliques = 0;
+}
+
+
+struct CliqueSearch // state of the search from one vertex
+{
+  const long int *offset; // CSR rows
+  const int *adj;
+  int minSize; // smallest clique listed
+  double deadline; // omp_get_wtime() to stop at
+  CliqueList *cl; // cliques found
+  int *clique; // vertices of current clique
+  long int calls; // calls of expand so far
+  int stopped; // 1 once deadline has passed (Boolean)
+};
+
+
+// entries of sorted set that are in sorted row, copied to out unless it is
+// NULL; return how many
+long int intersectRow(const int *set, long int n, const int *row, long int len, int *out)
+{
+  long int found = 0;
+  if (len > 8 * n) // long row: search it for each entry
+    for (long int i = 0; i < n; i++) {
+      if (!std::binary_search(row, row + len, set[i]))
+	continue;
+      if (out != NULL)
+	out[found] = set[i];
+      found++;
+    }
+  else // merge
+    for (long int i = 0, j = 0; (i < n) && (j < len); )
+      if (set[i] < row[j])
+	i++;
+      else if (set[i] > row[j])
+	j++;
+      else {
+	if (out != NULL)
+	  out[found] = set[i];
+	found++;
+	i++;
+	j++;
+      }
+  return found;
+}
+
+
+void addClique(CliqueList *cl, int *clique, int size)
+{
+  while (cl->num + size + 2 > cl->cap) { // double the array
+    cl->cap *= 2;
+    if ((cl->value = (int *)realloc(cl->value, cl->cap * sizeof(int))) == NULL)
+      fatal("memory not allocated");
+  }
+
+  cl->value[cl->num++] = clique[0]; // earliest vertex, the search it came from
+  cl->value[cl->num++] = size;
+  std::copy(clique, clique + size, cl->value + cl->num);
+  std::sort(cl->value + cl->num, cl->value + cl->num + size);
+  cl->num += size;
+  cl->numCliques++;
+}
+
+
+// Bron-Kerbosch: extend the r vertices of s->clique by candidates P,
+// where X holds vertices already tried (both sorted); X has room for np
+// more entries
+void expand(CliqueSearch *s, int r, int *P, long int np, int *X, long int nx)
+{
+  if (s->stopped)
+    return;
+  if (((s->calls++ & 63) == 0) && (omp_get_wtime() > s->deadline)) {
+    s->stopped = 1;
+    return;
+  }
+
+  if (np == 0) {
+    if ((nx == 0) && (r >= s->minSize)) // nothing can be added: maximal
+      addClique(s->cl, s->clique, r);
+    return;
+  }
+  if (r + np < s->minSize)
+    return; // too small whatever is added
+
+  // pivot on the vertex with the most candidates as neighbours; only
+  // candidates that aren't its neighbours need to be tried
+  int pivot = P[0];
+  long int most = -1;
+  for (long int i = 0; i < np + nx; i++) {
+    int u = (i < np) ? P[i] : X[i-np];
+    long int c = intersectRow(P, np, s->adj + s->offset[u], s->offset[u+1] - s->offset[u], NULL);
+    if (c > most) {
+      most = c;
+      pivot = u;
+    }
+  }
+
+  int *tryList, *newP, *newX; // candidates to try, and P and X of each extension
+  if (((tryList = new int[np]) == NULL) || ((newP = new int[np]) == NULL) || ((newX = new int[np + nx]) == NULL))
+    fatal("memory not allocated");
+
+  const int *pivotRow = s->adj + s->offset[pivot];
+  long int pivotLen = s->offset[pivot+1] - s->offset[pivot];
+  long int numTry = 0;
+  for (long int i = 0; i < np; i++)
+    if (!std::binary_search(pivotRow, pivotRow + pivotLen, P[i]))
+      tryList[numTry++] = P[i];
+
+  for (long int t = 0; (t < numTry) && !s->stopped; t++) {
+    int w = tryList[t];
+    const int *row = s->adj + s->offset[w];
+    long int len = s->offset[w+1] - s->offset[w];
+
+    s->clique[r] = w;
+    long int newNp = intersectRow(P, np, row, len, newP);
+    long int newNx = intersectRow(X, nx, row, len, newX);
+    expand(s, r + 1, newP, newNp, newX, newNx);
+
+    // w has been tried: move it from P to X
+    long int at = std::lower_bound(P, P + np, w) - P;
+    std::copy(P + at + 1, P + np, P + at);
+    np--;
+    at = std::lower_bound(X, X + nx, w) - X;
+    std::copy_backward(X + at, X + nx, X + nx + 1);
+    X[at] = w;
+    nx++;
+  }
+
+  delete [] tryList;
+  delete [] newP;
+  delete [] newX;
+}
+
+
+int cliquesFrom(int v, const long int *offset, const int *adj, const int *rank, int minSize, double deadline, CliqueList *cl)
+{
+  long int deg = offset[v+1] - offset[v];
+  int *P, *X; // later and earlier neighbours of v
+  CliqueSearch s;
+  if (((P = new int[deg]) == NULL) || ((X = new int[deg]) == NULL) || ((s.clique = new int[deg + 1]) == NULL))
+    fatal("memory not allocated");
+
+  long int np = 0, nx = 0;
+  for (long int e = offset[v]; e < offset[v+1]; e++) {
+    int u = adj[e];
+    if ((rank[u] > rank[v]) || ((rank[u] == rank[v]) && (u > v)))
+      P[np++] = u;
+    else
+      X[nx++] = u;
+  }
+
+  s.offset = offset;
+  s.adj = adj;
+  s.minSize = minSize;
+  s.deadline = deadline;
+  s.cl = cl;
+  s.calls = 0;
+  s.stopped = 0;
+  s.clique[0] = v;
+  expand(&s, 1, P, np, X, nx);
+
+  delete [] P;
+  delete [] X;
+  delete [] s.clique;
+  return !s.stopped;
+}
@@ -0,0 +1,46 @@
+// -------------------------------------------------------------------------
+// cores.h -   Header file for k-cores and maximal cliques of networks
+//             given as compressed sparse row (CSR) arrays
+//
+// Rows must hold both (i,j) and (j,i) entries, in increasing order.
+// Core numbers are found in parallel by peeling: every vertex whose
+// degree among the vertices left is k goes at once, the degrees of its
+// neighbours drop, and those that reach k go in the next round, until
+// no vertex of degree k is left.  The round each vertex goes in orders
+// the vertices so that each has at most its core number of neighbours
+// later in the order (a degeneracy order).
+//
+// Maximal cliques are listed by Bron-Kerbosch with pivoting, started
+// once from each vertex with its later neighbours as candidates, so each
+// clique is found once, from its earliest vertex, and the searches from
+// different vertices are independent.  Searches stop when the deadline
+// (omp_get_wtime() seconds) passes.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _CORES_H
+#define _CORES_H
+
+struct CliqueList // cliques found, each stored as its first vertex, size and vertices
+{
+  int *value; // records of cliques found so far
+  long int num; // ints used
+  long int cap; // ints allocated
+  long int numCliques; // number of cliques
+};
+
+// core number of each vertex of network with numNodes vertices, and the
+// peeling round it went in (rank)
+void coreNumbers(int numNodes, const long int *offset, const int *adj, int *core, int *rank);
+
+void startCliques(CliqueList *cl); // no cliques yet
+void freeCliques(CliqueList *cl); // release memory
+
+// add to cl the maximal cliques of at least minSize vertices whose
+// earliest vertex in the order of rank (ties by vertex number) is v,
+// with vertices in increasing order; return 0 if deadline passed first
+int cliquesFrom(int v, const long int *offset, const int *adj, const int *rank, int minSize, double deadline, CliqueList *cl);
+
+#endif
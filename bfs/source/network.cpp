@@ -8,233 +8,885 @@
 /   Breadth-first search added October/November 2007
 /   Print out component size summary (PRINTCOMPSIZES)
 /    added January 2011
+/   Two-phase loading into CSR adjacency arrays
+/    added October 2026
+/   Parallel connected components (Afforest)
+/    added October 2026
+/   Mapped graph files (mapEdges, saveGraph)
+/    added October 2026
+/   Component statistics by selection (compstats), COMP_STATS
+/    added October 2026
+/   Single-linkage dendrogram from maximum spanning forest
+/    added October 2026
+/   Parallel k-cores and maximal cliques of large components (cores)
+/    added October 2026
+/   Louvain communities of large components (communities)
+/    added October 2026
 /
 /**********************************************************/
 
 
 #include "network.h"
+#include <vector>
+#include <omp.h>
 
 using namespace std;
 
-Edge::Edge(int endpt, double wt) // create a new edge with default weight of 1
-{  
-  if (weight < 0-TOL) fatal("Negative edge weight");
-  if (endpt < 0)  fatal("Invalid endpoint for edge");
+Network::Network(int num, int dir, int sym, int wtd) // create a network with num vertices
+{
+  if (num < 1)  fatal("Network requires at least 1 vertex");
+  numVertices = num;
+  directed = dir; // 0 if undirected, 1 if directed network
+  symmetric = sym; // 1 to keep (j,i) entries as well as (i,j)
+  weighted = wtd; // 1 to keep edge weights
 
-  target = endpt; // assign endpoint
-  weight = wt; // assign weight
+  if(((degree = new int[numVertices]) == NULL) || ((offset = new long int[numVertices+1]) == NULL))
+    fatal("memory not allocated"); // allocate memory
+
+  for (int i = 0; i < numVertices; i++)
+    degree[i] = 0; // no incident edges yet
+  for (int i = 0; i <= numVertices; i++)
+    offset[i] = 0;
+
+  numEdges = 0; // no edges added yet
+  numStaged = 0;
+  numBlocks = 0;
+  capBlocks = 0;
+  block = NULL;
+  target = NULL;
+  weight = NULL;
+  finished = 0;
+  mapped = 0;
 }
 
-int Edge::getTarget() // get other edgepoint  
+
+Network::~Network() // destructor
 {
-  return target;
+  for (int b = 0; b < numBlocks; b++)
+    delete [] block[b];
+  free(block);
+  delete [] degree;
+  if (!mapped) { // mapped arrays belong to graph file
+    delete [] offset;
+    delete [] target;
+    delete [] weight;
+  }
 }
-  
-double Edge::getWeight() // get weight of edge 
+
+int Network::getNvertices() // get number of vertices in network
 {
-  return weight;  
+  return numVertices;
 }
 
-Vertex::Vertex() // create a new vertex
+int Network::getNumEdges() // get number of vertices in network
 {
-  //if (indxNum < 0)  fatal("Vertex indices must be non-negative");
-  //index = indxNum; // assign index of node
-  //ID = GML; // assign GML ID number
-  //label = lbl; // assign GML label
-  degree = 0; // no incident edges yet
-  firstEdge.next = 0; // first edge is pointed to by firstEdge.next
+  return numEdges;
 }
 
-Vertex::~Vertex() // destructor
+int Network::getDegree(int vertex) // get degree of node
 {
-  /* delete edges; 
-  Edge *edgePtr, *followPtr; // pointers to move through linked list of edges
-  edgePtr = &firstEdge; // point to first edge
-  followPtr = edgePtr;  
-
-  while (edgePtr->next != 0) {// follow until find last edge
-    edgePtr = edgePtr->next; // pointer points at next edge in list
-    delete followPtr;
-    followPtr = edgePtr;
-  }
-  Need to fix!!!!!!!!!!!!!!!!!!!!!!!!
-  */
+  return degree[vertex];
 }
 
-//int Vertex::getID() // get GML ID number of vertex
+int Network::isDirected() // return 0 if undirected, 1 if directed network
+{
+  return directed;
+}
 
-//note: firstEdge is a placeholder that points to true first edge
-int Vertex::addEdge(int endpt, double wt) // add an edge to vertex, return 1 if successful
+int Network::addEdge(int v1, int v2, double wt) // stage edge, return 1
 {
-  if (endpt < 0) fatal("invalid endpoint for edge");
+  if ((v1 > numVertices-1) || (v2 > numVertices-1))
+    fatal("Attempt to add edge to non-existent node");
+  if ((v1 < 0) || (v2 < 0))
+    fatal("Attempt to add edge to negative numbered node");
   if (wt < 0-TOL) fatal("invalid weight for edge");
+  if (wt > 1+TOL) fatal("Edge weight above 1; weights are stored as CCC values from 0 to 1");
+  if (finished) fatal("Attempt to add edge after finishEdges");
 
-  Edge *edgePtr; // pointer to move through linked list of edges
-  edgePtr = &firstEdge; // point to first edge
+  if (!DIRECTED) {
+    if (v1 > v2) { // order v1 and v2
+      int temp = v1;
+      v1 = v2;
+      v2 = temp;
+    }
+  }
 
-  while (edgePtr->next != 0) // follow until find last edge
-    edgePtr = edgePtr->next; // pointer points at next edge in list
+  if ((numStaged >> STAGE_SHIFT) == numBlocks) { // last block is full
+    if (numBlocks == capBlocks) {
+      capBlocks = (capBlocks == 0) ? 64 : 2 * capBlocks;
+      if ((block = (StagedEdge **)realloc(block, capBlocks * sizeof(StagedEdge *))) == NULL)
+	fatal("memory not allocated for edge");
+    }
 
-  Edge *newEdge; // newEdge created
-  if((newEdge = new Edge) == NULL)
-    fatal("memory not allocated for edge");
+    if ((block[numBlocks++] = new StagedEdge[1L << STAGE_SHIFT]) == NULL)
+      fatal("memory not allocated for edge");
+  }
 
-  edgePtr->next = newEdge; // add new edge to list
-  newEdge->target = endpt; // assign properties to new edge
-  newEdge->weight = wt;
-  newEdge->next = 0; // mark new edge as last on list
+  StagedEdge *staged = stagedEdge(numStaged++);
+  staged->v1 = v1;
+  staged->v2 = v2;
+  staged->weight = quantiseWeight(wt);
 
   return 1;
 }
 
-double Vertex::getWeight(int endpoint) // return weight of edge
+StagedEdge* Network::stagedEdge(long int e) // staged edge with given index
 {
-  Edge *edgePtr; // pointer to move through linked list of edges
-  edgePtr = &firstEdge; // point to first edge
+  return &block[e >> STAGE_SHIFT][e & ((1L << STAGE_SHIFT) - 1)];
+}
+
+int Network::finishEdges() // build CSR arrays, return number of duplicates dropped
+{
+  if (finished) return 0;
+
+  // place each (i,j) in row i, then free the staging arena
+  for (long int e = 0; e < numStaged; e++)
+    if (stagedEdge(e)->v1 != stagedEdge(e)->v2) // self-loop doesn't join anything
+      offset[stagedEdge(e)->v1 + 1]++;
+
+  for (int i = 0; i < numVertices; i++)
+    offset[i+1] += offset[i];
+
+  if(((target = new int[offset[numVertices]]) == NULL) || (weighted && ((weight = new unsigned short[offset[numVertices]]) == NULL)))
+    fatal("memory not allocated for edges");
+
+  long int *next; // next free entry of each vertex
+  if ((next = new long int[numVertices]) == NULL)
+    fatal("memory not allocated");
+  for (int i = 0; i < numVertices; i++)
+    next[i] = offset[i];
+
+  for (long int e = 0; e < numStaged; e++) {
+    StagedEdge *staged = stagedEdge(e);
+    if (staged->v1 == staged->v2)
+      continue;
+
+    if (weighted)
+      weight[next[staged->v1]] = staged->weight;
+    target[next[staged->v1]++] = staged->v2;
+  }
+
+  for (int b = 0; b < numBlocks; b++)
+    delete [] block[b];
+  free(block);
+  block = NULL;
+  numBlocks = capBlocks = 0;
+
+  // sort each row with the highest weight first among duplicates, and
+  // keep the first of each target, compacting rows toward the front
+  long int maxRow = 0; // longest row
+  for (int i = 0; i < numVertices; i++)
+    maxRow = std::max(maxRow, offset[i+1] - offset[i]);
 
-  for (int i = 0; i < endpoint; i++)
-    edgePtr = edgePtr->next; // pointer points at next edge in list
+  unsigned long int *key; // target and inverted weight of each entry of a row
+  if ((key = new unsigned long int[maxRow + 1]) == NULL)
+    fatal("memory not allocated");
 
-  return edgePtr->weight;
+  long int numUnique = 0; // entries kept so far
+  for (int i = 0; i < numVertices; i++) {
+    long int first = offset[i], last = offset[i+1]; // row before compaction
+    long int rowLength = last - first;
+
+    for (long int e = 0; e < rowLength; e++)
+      key[e] = ((unsigned long int)target[first+e] << 16) | (weighted ? 65535 - weight[first+e] : 0);
+    std::sort(key, key + rowLength);
+
+    offset[i] = numUnique; // row starts where last one ended
+    for (long int e = 0; e < rowLength; e++) {
+      if ((e > 0) && ((key[e] >> 16) == (key[e-1] >> 16)))
+	continue; // duplicate of entry already kept
+
+      target[numUnique] = (int)(key[e] >> 16);
+      if (weighted)
+	weight[numUnique] = 65535 - (unsigned short)(key[e] & 65535);
+      numUnique++;
+
+      degree[i]++; // update degree of vertices
+      if (!DIRECTED)
+	degree[target[numUnique-1]]++; // increase degree for both vertices if undirected
+    }
+  }
+  offset[numVertices] = numUnique;
+
+  delete [] key;
+  int numDup = (int)(numStaged - numUnique); // duplicates and self-loops dropped
+  numStaged = 0;
+  numEdges = (int)numUnique;
+
+  if (symmetric) { // add (j,i) entries to each row
+    long int *full; // offsets of rows with both directions
+    int *fullTarget;
+    unsigned short *fullWeight = NULL;
+
+    if (((full = new long int[numVertices+1]) == NULL) || ((fullTarget = new int[2*numUnique]) == NULL) || (weighted && ((fullWeight = new unsigned short[2*numUnique]) == NULL)))
+      fatal("memory not allocated for edges");
+
+    // count both directions of each edge
+    for (int i = 0; i <= numVertices; i++)
+      full[i] = 0;
+    for (int i = 0; i < numVertices; i++)
+      for (long int e = offset[i]; e < offset[i+1]; e++) {
+	full[i+1]++;
+	full[target[e]+1]++;
+      }
+    for (int i = 0; i < numVertices; i++)
+      full[i+1] += full[i];
+
+    for (int i = 0; i < numVertices; i++)
+      next[i] = full[i];
+
+    // reverse (j,i) entries first, then (i,j), so each row of an
+    // undirected network is in increasing order of target
+    for (int i = 0; i < numVertices; i++)
+      for (long int e = offset[i]; e < offset[i+1]; e++) {
+	if (weighted)
+	  fullWeight[next[target[e]]] = weight[e];
+	fullTarget[next[target[e]]++] = i;
+      }
+
+    for (int i = 0; i < numVertices; i++)
+      for (long int e = offset[i]; e < offset[i+1]; e++) {
+	if (weighted)
+	  fullWeight[next[i]] = weight[e];
+	fullTarget[next[i]++] = target[e];
+      }
+
+    delete [] offset;
+    delete [] target;
+    delete [] weight;
+    offset = full;
+    target = fullTarget;
+    weight = fullWeight;
+  }
+
+  else { // release entries dropped by compaction
+    int *shrunk;
+    if ((shrunk = new int[numUnique]) == NULL)
+      fatal("memory not allocated for edges");
+    std::copy(target, target + numUnique, shrunk);
+    delete [] target;
+    target = shrunk;
+  }
+
+  delete [] next;
+  finished = 1;
+
+  return numDup;
 }
 
-void Vertex::changeWeight(int endpoint, double newWeight) // change weight of edge
+void Network::link(int v1, int v2, int *root) // join components of v1 and v2, lower root wins
 {
-  Edge *edgePtr; // pointer to move through linked list of edges
-  edgePtr = &firstEdge; // point to first edge
+  int r1 = root[v1], r2 = root[v2];
 
-  for (int i = 0; i < endpoint; i++)
-	edgePtr = edgePtr->next; // pointer points at next edge in list
+  while (r1 != r2) {
+    int high = (r1 > r2) ? r1 : r2;
+    int low = r1 + r2 - high;
+    int rHigh = root[high];
 
-  edgePtr->weight = newWeight;
+    if ((rHigh == low) || ((rHigh == high) && __sync_bool_compare_and_swap(&root[high], high, low)))
+      break; // already joined, or high hooked under low
+
+    r1 = root[root[high]]; // another thread moved high, try again
+    r2 = root[low];
+  }
 }
 
-int Vertex::haveEdge(int endpoint) // return 1 if edge exists, 0 if not
+void Network::compress(int *root) // point each vertex straight at its root
 {
-  Edge *edgePtr; // pointer to move through linked list of edges
-  edgePtr = &firstEdge; // point to first edge
+  #pragma omp parallel for schedule(dynamic, 16384)
+  for (int i = 0; i < numVertices; i++)
+    while (root[i] != root[root[i]])
+      root[i] = root[root[i]];
+}
 
-  if (edgePtr->next == 0) // no edges for this vertex
-    return 0;
+void Network::findComponents(int *root, int *firstMember, int *members) // connected components in parallel
+{
+  #pragma omp parallel for
+  for (int i = 0; i < numVertices; i++)
+    root[i] = i; // each vertex is its own component
+
+  // Afforest: link a few neighbours of every vertex, which joins most of
+  // the giant component, then only visit vertices outside it
+  for (int r = 0; r < LINK_ROUNDS; r++) {
+    #pragma omp parallel for schedule(dynamic, 16384)
+    for (int i = 0; i < numVertices; i++)
+      if (offset[i] + r < offset[i+1])
+	link(i, target[offset[i]+r], root);
+    compress(root);
+  }
 
-  while (edgePtr->next != 0) { // follow until find last edge
-    edgePtr = edgePtr->next; // pointer points at next edge in list
-    if (edgePtr->target == endpoint)
-      return 1;
+  int big = -1; // root of largest component in sample, skipped below
+  if (symmetric && !directed) { // edge (i,j) of skipped i is still in row of j
+    int sample[COMP_SAMPLES]; // roots of evenly spaced vertices
+    for (int s = 0; s < COMP_SAMPLES; s++)
+      sample[s] = root[(long int)s * numVertices / COMP_SAMPLES];
+    std::sort(sample, sample + COMP_SAMPLES);
+
+    int bestRun = 0;
+    for (int s = 0, run = 1; s < COMP_SAMPLES; s++, run++)
+      if ((s == COMP_SAMPLES-1) || (sample[s+1] != sample[s])) {
+	if (run > bestRun) {
+	  bestRun = run;
+	  big = sample[s];
+	}
+	run = 0;
+      }
   }
 
-  return 0;
+  #pragma omp parallel for schedule(dynamic, 16384)
+  for (int i = 0; i < numVertices; i++) {
+    if (root[i] == big)
+      continue;
+    for (long int e = offset[i] + LINK_ROUNDS; e < offset[i+1]; e++)
+      link(i, target[e], root);
+  }
+  compress(root);
+
+  // roots are the lowest vertex of each component, as the serial BFS
+  // met them; list members of each root in increasing order
+  for (int i = 0; i <= numVertices; i++)
+    firstMember[i] = 0;
+
+  for (int i = 0; i < numVertices; i++)
+    firstMember[root[i]+1]++;
+
+  for (int i = 0; i < numVertices; i++)
+    firstMember[i+1] += firstMember[i];
+
+  int *next; // next free place of each root
+  if ((next = new int[numVertices]) == NULL)
+    fatal("memory not allocated");
+  for (int i = 0; i < numVertices; i++)
+    next[i] = firstMember[i];
+
+  for (int i = 0; i < numVertices; i++)
+    members[next[root[i]]++] = i;
+
+  delete [] next;
 }
 
-int Vertex::getDegree() // get out-degree (full degree for undirected)
+void Network::mapEdges(GraphFile *gf) // use CSR arrays of mapped graph file in place of addEdge
 {
-  return degree;
-}
+  if (finished || (numStaged > 0)) fatal("Mapped edges can't be mixed with added edges");
+  if (symmetric) fatal("Graph files hold each edge once; load edges with addEdge to keep (j,i) entries");
+  if (gf->numNodes != numVertices) fatal("Graph file has a different number of vertices");
+
+  delete [] offset; // arrays of file are used as they are
+  offset = (long int *)gf->offset;
+  target = (int *)gf->target;
+  weight = weighted ? (unsigned short *)gf->weight : NULL;
+  mapped = 1;
 
-//char* Vertex::getLabel() // get GML label of vertex (NULL if none specified)
+  for (int i = 0; i < numVertices; i++) {
+    degree[i] += offset[i+1] - offset[i];
+    for (long int e = offset[i]; e < offset[i+1]; e++)
+      degree[target[e]]++; // edges are undirected
+  }
 
-Edge* Vertex::getEdges() // get copy of edges eminating from vertex
+  numEdges = (int)gf->numEdges;
+  finished = 1;
+}
+
+int Network::saveGraph(char *fileName, int *id, int twoNode) // write CSR arrays to graph file, return 1 if successful
 {
-  Edge* edge1; // FIX
-  return edge1;
+  finishEdges(); // no-op if already called
+
+  if (directed) fatal("Graph files hold undirected networks");
+  if (!weighted) fatal("Need to keep edge weights to save graph file");
+
+  return writeGraph(fileName, numVertices, twoNode, id, offset, target, weight);
 }
 
-void Vertex::printEdges(int node, char *outputFile) // print edges eminating from vertex
+// single-linkage dendrogram of the network from its maximum spanning
+// forest, written to fileName, and the clusters at each of numCuts
+// thresholds in cut written to fileName.cuts
+void Network::dendrogram(char *fileName, double *cut, int numCuts)
 {
-  Edge *edgePtr; // pointer to move through linked list of edges
-  edgePtr = &firstEdge; // point to first edge
+  finishEdges(); // no-op if already called
 
-  if (edgePtr->next == 0) return; // no edges from this node
+  if (directed) fatal("Dendrogram needs an undirected network");
+  if (!weighted) fatal("Need to keep edge weights for dendrogram");
 
-  FILE *output; 
-  if ((output = fopen(outputFile, "a")) == NULL)
-      fatal ("Unable to open output file");
+  // order (i,j) entries by decreasing weight with a counting sort, as
+  // weights are quantised to 16 bits
+  long int *start; // first place in order of each weight, highest first
+  long int *order; // entries in order of decreasing weight
+  int *source; // vertex of each entry
+  if (((start = new long int[65537]) == NULL) || ((order = new long int[numEdges]) == NULL) || ((source = new int[offset[numVertices]]) == NULL))
+    fatal("memory not allocated");
 
-  while (edgePtr->next != 0) { // follow until find last edge
-    edgePtr = edgePtr->next; // pointer points at next edge in list
+  for (int w = 0; w <= 65536; w++)
+    start[w] = 0;
+  for (int i = 0; i < numVertices; i++)
+    for (long int e = offset[i]; e < offset[i+1]; e++) {
+      source[e] = i;
+      if (!symmetric || (i < target[e])) // each edge once
+	start[65535 - weight[e] + 1]++;
+    }
+  for (int w = 0; w < 65536; w++)
+    start[w+1] += start[w];
+  for (long int e = 0; e < offset[numVertices]; e++)
+    if (!symmetric || (source[e] < target[e]))
+      order[start[65535 - weight[e]]++] = e;
+
+  // Kruskal: join components along edges from the heaviest down; each
+  // edge that joins two components is a merge of the dendrogram
+  int *root, *size, *label; // union-find parent, component size and cluster label of each root
+  int *merge; // entry of each merge
+  if (((root = new int[numVertices]) == NULL) || ((size = new int[numVertices]) == NULL) || ((label = new int[numVertices]) == NULL) || ((merge = new int[numVertices]) == NULL))
+    fatal("memory not allocated");
 
-    if(!RETAINSYMMETRIC || (node < edgePtr->target)) // print only once
-      fprintf(output,"\n\tedge\n\t[\n\tsource %d\n\ttarget %d\n\t]", node+1, edgePtr->target+1);
+  for (int i = 0; i < numVertices; i++) {
+    root[i] = i;
+    size[i] = 1;
+    label[i] = i; // leaves are the vertices, as numbered in the .bfs file
   }
 
+  FILE *output;
+  if ((output = fopen(fileName, "w")) == NULL)
+    fatal("Dendrogram file could not be opened");
+
+  int numMerges = 0;
+  for (long int k = 0; k < numEdges; k++) {
+    long int e = order[k];
+    int r1 = source[e], r2 = target[e];
+    while (root[r1] != r1)
+      r1 = root[r1] = root[root[r1]]; // path halving
+    while (root[r2] != r2)
+      r2 = root[r2] = root[root[r2]];
+    if (r1 == r2)
+      continue; // already in the same component
+
+    if (size[r1] < size[r2]) // smaller component goes under larger
+      std::swap(r1, r2);
+
+    fprintf(output, "%d %d %f %d\n", std::min(label[r1], label[r2]), std::max(label[r1], label[r2]), weightValue(weight[e]), size[r1] + size[r2]);
+    root[r2] = r1;
+    size[r1] += size[r2];
+    label[r1] = numVertices + numMerges; // merges are numbered after the vertices
+    merge[numMerges] = (int)k;
+    numMerges++;
+  }
   fclose(output);
-}
 
-Network::Network(int num, int dir) // create a network with num vertices
-{
-  if (num < 1)  fatal("Network requires at least 1 vertex");
-  numVertices = num;
-  directed = dir; // 0 if undirected, 1 if directed network
-  if((vertices = new Vertex[numVertices]) == NULL)
-    fatal("memory not allocated"); // allocate memory
+  cout << numMerges << " merges written to '" << fileName << "'" << endl;
 
-  numEdges = 0; // no edges added yet
-}
+  if (numCuts > 0) { // clusters at each threshold from the merges above it
+    char cutName[500];
+    sprintf(cutName, "%.490s.cuts", fileName);
+    if ((output = fopen(cutName, "w")) == NULL)
+      fatal("Cuts file could not be opened");
 
+    int *clusterNum;
+    if ((clusterNum = new int[numVertices]) == NULL)
+      fatal("memory not allocated");
 
-Network::~Network() // destructor
-{
-  delete [] vertices; 
-}
+    for (int c = 0; c < numCuts; c++) {
+      for (int i = 0; i < numVertices; i++) {
+	root[i] = i;
+	size[i] = 1;
+      }
 
-int Network::getNvertices() // get number of vertices in network
-{
-  return numVertices;
+      long int cutEdges = 0; // edges at least as heavy as the threshold, at the precision of the weights
+      while ((cutEdges < numEdges) && (weight[order[cutEdges]] >= quantiseWeight(cut[c])))
+	cutEdges++;
+
+      for (int m = 0; (m < numMerges) && (merge[m] < cutEdges); m++) {
+	long int e = order[merge[m]];
+	int r1 = source[e], r2 = target[e];
+	while (root[r1] != r1)
+	  r1 = root[r1] = root[root[r1]]; // path halving
+	while (root[r2] != r2)
+	  r2 = root[r2] = root[root[r2]];
+	if (r1 > r2) // lowest vertex is root
+	  std::swap(r1, r2);
+	root[r2] = r1;
+	size[r1] += size[r2];
+      }
+
+      // clusters are numbered in order of their lowest vertex, as bfs
+      // numbers them
+      int numClusters = 0;
+      for (int i = 0; i < numVertices; i++) {
+	int r = i;
+	while (root[r] != r)
+	  r = root[r];
+	if (size[r] == 1)
+	  clusterNum[i] = -1; // singleton at this threshold
+	else if (r == i)
+	  clusterNum[i] = numClusters++;
+	else
+	  clusterNum[i] = clusterNum[r];
+      }
+
+      fprintf(output, "threshold %f: %d nodes %d clusters %ld edges\n", cut[c], numVertices, numClusters, cutEdges);
+      for (int i = 0; i < numVertices; i++)
+	fprintf(output, "%d ", clusterNum[i]);
+      fprintf(output, "\n\n");
+    }
+
+    fclose(output);
+    delete [] clusterNum;
+    cout << numCuts << " thresholds written to '" << cutName << "'" << endl;
+  }
+
+  delete [] start;
+  delete [] order;
+  delete [] source;
+  delete [] root;
+  delete [] size;
+  delete [] label;
+  delete [] merge;
 }
 
-int Network::getNumEdges() // get number of vertices in network
+// point rowOffset and adj at CSR rows holding both (i,j) and (j,i)
+// entries in increasing order, built from the one-way entries if
+// needed, and if adjWeight isn't NULL allocate the weight of each entry;
+// return 1 if rowOffset and adj were allocated
+int Network::fullRows(long int **rowOffset, int **adj, double **adjWeight)
 {
-  return numEdges;
+  *rowOffset = offset;
+  *adj = target;
+  if (adjWeight != NULL) {
+    if ((*adjWeight = new double[2L * numEdges]) == NULL)
+      fatal("memory not allocated");
+    for (long int e = 0; symmetric && (e < offset[numVertices]); e++)
+      (*adjWeight)[e] = weightValue(weight[e]);
+  }
+  if (symmetric)
+    return 0;
+
+  long int *next; // next free place in each row
+  if (((*rowOffset = new long int[numVertices+1]) == NULL) || ((*adj = new int[2L * numEdges]) == NULL) || ((next = new long int[numVertices]) == NULL))
+    fatal("memory not allocated");
+
+  (*rowOffset)[0] = 0;
+  for (int i = 0; i < numVertices; i++) {
+    (*rowOffset)[i+1] = (*rowOffset)[i] + degree[i];
+    next[i] = (*rowOffset)[i];
+  }
+
+  for (int i = 0; i < numVertices; i++) // lower neighbours of i are already in its row
+    for (long int e = offset[i]; e < offset[i+1]; e++) {
+      if (adjWeight != NULL)
+	(*adjWeight)[next[i]] = (*adjWeight)[next[target[e]]] = weightValue(weight[e]);
+      (*adj)[next[i]++] = target[e];
+      (*adj)[next[target[e]]++] = i;
+    }
+
+  delete [] next;
+  return 1;
 }
 
-int Network::getDegree(int vertex) // get degree of node
+// order of two clique records (first vertex, size, members in increasing
+// order) by their members, so the clique with the lowest vertex is first
+static bool cliqueBefore(const int *a, const int *b)
 {
-  int degree = vertices[vertex].getDegree();
-  return degree;
+  return std::lexicographical_compare(a + 2, a + 2 + a[1], b + 2, b + 2 + b[1]);
 }
 
-int Network::isDirected() // return 0 if undirected, 1 if directed network
+// core numbers of the vertices of each component of at least minSize
+// vertices, written to fileName, and if seconds > 0 the maximal cliques
+// of these components found in that time, written to fileName.cliques
+void Network::cores(char *fileName, int minSize, double seconds)
 {
-  return directed;
+  finishEdges(); // no-op if already called
+
+  if (directed) fatal("Core numbers need an undirected network");
+
+  long int *fullOffset; // rows with both (i,j) and (j,i) entries
+  int *adj;
+  int copied = fullRows(&fullOffset, &adj, NULL);
+
+  int *core, *rank; // core number and peeling round of each vertex
+  if (((core = new int[numVertices]) == NULL) || ((rank = new int[numVertices]) == NULL))
+    fatal("memory not allocated");
+  coreNumbers(numVertices, fullOffset, adj, core, rank);
+
+  int *root, *firstMember, *members; // lowest vertex of each component and members by root
+  int *chosen, *chosenNum; // lowest vertex and cluster number of each component given core numbers
+  if(((root = new int[numVertices]) == NULL) || ((firstMember = new int[numVertices+1]) == NULL) || ((members = new int[numVertices]) == NULL) || ((chosen = new int[numVertices/minSize + 1]) == NULL) || ((chosenNum = new int[numVertices/minSize + 1]) == NULL))
+    fatal("memory not allocated");
+  findComponents(root, firstMember, members);
+
+  FILE *output;
+  if ((output = fopen(fileName, "w")) == NULL)
+    fatal("Cores file could not be opened");
+
+  int k = 0; // cluster number, as in the .bfs file
+  int numChosen = 0;
+  int maxCore = 0; // highest core number of chosen components
+  for (int i = 0; i < numVertices; i++) {
+    if ((degree[i] == 0) || (root[i] != i))
+      continue; // singleton, or not lowest vertex of component
+    k++;
+    int *component = members + firstMember[i]; // members in increasing order
+    int size = firstMember[i+1] - firstMember[i];
+    if (size < minSize)
+      continue;
+
+    long int compEdges = 0; // edges in component
+    int compCore = 0, numInCore = 0; // highest core number, and vertices with it
+    for (int j = 0; j < size; j++) {
+      compEdges += degree[component[j]];
+      if (core[component[j]] > compCore) {
+	compCore = core[component[j]];
+	numInCore = 0;
+      }
+      if (core[component[j]] == compCore)
+	numInCore++;
+    }
+
+    fprintf(output, "cluster %d: %d nodes %ld edges, max core %d (%d nodes)\n", k-1, size, compEdges / 2, compCore, numInCore);
+    for (int j = 0; j < size; j++)
+      fprintf(output, "%d ", component[j]);
+    fprintf(output, "\n");
+    for (int j = 0; j < size; j++)
+      fprintf(output, "%d ", core[component[j]]);
+    fprintf(output, "\n\n");
+
+    chosen[numChosen] = i;
+    chosenNum[numChosen++] = k-1;
+    if (compCore > maxCore)
+      maxCore = compCore;
+  }
+  fclose(output);
+
+  cout << numChosen << " components of " << minSize << " or more vertices (highest core number " << maxCore << ") written to '" << fileName << "'" << endl;
+
+  if (seconds > 0) { // Bron-Kerbosch from every vertex of each chosen component
+    char cliqueName[500];
+    sprintf(cliqueName, "%.490s.cliques", fileName);
+    if ((output = fopen(cliqueName, "w")) == NULL)
+      fatal("Cliques file could not be opened");
+
+    int numThreads = omp_get_max_threads();
+    CliqueList *found; // cliques found by each thread
+    if ((found = new CliqueList[numThreads]) == NULL)
+      fatal("memory not allocated");
+    for (int t = 0; t < numThreads; t++)
+      startCliques(&found[t]);
+
+    double deadline = omp_get_wtime() + seconds;
+    long int numCliques = 0;
+    int searched = 0; // components searched
+    int complete = 1; // 0 once the deadline has passed (Boolean)
+
+    for (int c = 0; complete && (c < numChosen); c++) {
+      int *component = members + firstMember[chosen[c]];
+      int size = firstMember[chosen[c]+1] - firstMember[chosen[c]];
+      for (int t = 0; t < numThreads; t++)
+	found[t].num = found[t].numCliques = 0;
+
+      #pragma omp parallel for schedule(dynamic, 16)
+      for (int j = 0; j < size; j++)
+	if (complete && !cliquesFrom(component[j], fullOffset, adj, rank, MIN_CLIQUE, deadline, &found[omp_get_thread_num()]))
+	  complete = 0;
+      searched++;
+
+      // write cliques in order of their lowest vertex, whichever thread found them
+      std::vector<const int *> record; // record of each clique
+      int largest = 0;
+      for (int t = 0; t < numThreads; t++)
+	for (long int at = 0; at < found[t].num; at += found[t].value[at+1] + 2) {
+	  record.push_back(found[t].value + at);
+	  largest = std::max(largest, found[t].value[at+1]);
+	}
+      std::sort(record.begin(), record.end(), cliqueBefore);
+
+      fprintf(output, "cluster %d: %ld maximal cliques of %d or more nodes, largest %d%s\n", chosenNum[c], (long int)record.size(), MIN_CLIQUE, largest, complete ? "" : " (stopped at time limit)");
+      for (size_t r = 0; r < record.size(); r++) {
+	const int *clique = record[r];
+	for (int j = 0; j < clique[1]; j++)
+	  fprintf(output, "%d ", clique[j+2]);
+	fprintf(output, "\n");
+      }
+      fprintf(output, "\n");
+      numCliques += record.size();
+    }
+    fclose(output);
+
+    cout << numCliques << " maximal cliques of " << MIN_CLIQUE << " or more vertices in " << searched << " components written to '" << cliqueName << "'" << endl;
+    if (!complete)
+      cout << "Time limit of " << seconds << " seconds reached; cliques of the last component are incomplete and " << numChosen - searched << " components were not searched" << endl;
+
+    for (int t = 0; t < numThreads; t++)
+      freeCliques(&found[t]);
+    delete [] found;
+  }
+
+  if (copied) {
+    delete [] fullOffset;
+    delete [] adj;
+  }
+  delete [] core;
+  delete [] rank;
+  delete [] root;
+  delete [] firstMember;
+  delete [] members;
+  delete [] chosen;
+  delete [] chosenNum;
 }
 
-int Network::addEdge(int v1, int v2, double weight) // return 1 if successfully add edge
+// clusters of the .bfs file with each component of at least minSize
+// vertices split into its communities, written to fileName in the same
+// format
+void Network::communities(char *fileName, int minSize)
 {
-  if ((v1 > numVertices-1) || (v2 > numVertices-1))
-    fatal("Attempt to add edge to non-existent node");
-  if ((v1 < 0) || (v2 < 0))
-    fatal("Attempt to add edge to negative numbered node");
+  finishEdges(); // no-op if already called
+
+  if (directed) fatal("Communities need an undirected network");
+  if (!weighted) fatal("Need to keep edge weights for communities");
+
+  long int *fullOffset; // rows with both (i,j) and (j,i) entries
+  int *adj;
+  double *adjWeight;
+  int copied = fullRows(&fullOffset, &adj, &adjWeight);
+
+  int *root, *firstMember, *members; // lowest vertex of each component and members by root
+  if(((root = new int[numVertices]) == NULL) || ((firstMember = new int[numVertices+1]) == NULL) || ((members = new int[numVertices]) == NULL))
+    fatal("memory not allocated");
+  findComponents(root, firstMember, members);
+
+  // vertices of the components to split, numbered from 0 in the order of
+  // their components; their neighbours are all in the same component
+  int *local, *vertex, *group; // number of each vertex among those split, vertex of each number, and component of each number
+  int *groupRoot, *groupNum; // lowest vertex and .bfs cluster number of each component split
+  if(((local = new int[numVertices]) == NULL) || ((vertex = new int[numVertices]) == NULL) || ((group = new int[numVertices]) == NULL) || ((groupRoot = new int[numVertices/minSize + 1]) == NULL) || ((groupNum = new int[numVertices/minSize + 1]) == NULL))
+    fatal("memory not allocated");
+
+  int n = 0, numGroups = 0;
+  int k = 0; // cluster number in the .bfs file
+  for (int i = 0; i < numVertices; i++) {
+    local[i] = -1;
+    if ((degree[i] == 0) || (root[i] != i))
+      continue;
+    k++;
+    if (firstMember[i+1] - firstMember[i] < minSize)
+      continue;
+    groupRoot[numGroups] = i;
+    groupNum[numGroups] = k-1;
+    for (int m = firstMember[i]; m < firstMember[i+1]; m++) {
+      vertex[n] = members[m];
+      group[n++] = numGroups;
+    }
+    numGroups++;
+  }
+  for (int v = 0; v < n; v++)
+    local[vertex[v]] = v;
+
+  long int *subOffset; // rows of the vertices to split, in their numbers
+  int *subAdj;
+  double *subWeight;
+  if ((subOffset = new long int[n+1]) == NULL)
+    fatal("memory not allocated");
+  subOffset[0] = 0;
+  for (int v = 0; v < n; v++)
+    subOffset[v+1] = subOffset[v] + fullOffset[vertex[v]+1] - fullOffset[vertex[v]];
+  if (((subAdj = new int[subOffset[n]]) == NULL) || ((subWeight = new double[subOffset[n]]) == NULL))
+    fatal("memory not allocated");
+
+  #pragma omp parallel for schedule(dynamic, 1024)
+  for (int v = 0; v < n; v++)
+    for (long int e = fullOffset[vertex[v]], f = subOffset[v]; e < fullOffset[vertex[v]+1]; e++, f++) {
+      subAdj[f] = local[adj[e]];
+      subWeight[f] = adjWeight[e];
+    }
 
-  if (!DIRECTED) {
-    if (v1 > v2) { // order v1 and v2
-      int temp = v1;
-      v1 = v2;
-      v2 = temp;
+  int *community; // lowest vertex number of the community of each vertex split
+  double *modularity; // of each component split
+  if (((community = new int[n]) == NULL) || ((modularity = new double[numGroups + 1]) == NULL))
+    fatal("memory not allocated");
+  louvain(n, subOffset, subAdj, subWeight, group, numGroups, community);
+  groupModularity(n, subOffset, subAdj, subWeight, group, numGroups, community, modularity);
+
+  // each cluster is known by its lowest vertex: the component's, or the
+  // community's if its component was split; clusters are numbered in
+  // order of their lowest vertex, as bfs numbers them
+  int *lowest, *size, *clusterNum; // lowest vertex of cluster of each vertex, size of each cluster by lowest vertex
+  if(((lowest = new int[numVertices]) == NULL) || ((size = new int[numVertices]) == NULL) || ((clusterNum = new int[numVertices]) == NULL))
+    fatal("memory not allocated");
+
+  for (int i = 0; i < numVertices; i++)
+    size[i] = 0;
+  for (int i = 0; i < numVertices; i++) {
+    lowest[i] = (local[i] < 0) ? root[i] : vertex[community[local[i]]];
+    size[lowest[i]]++;
+  }
+
+  int numClusters = 0;
+  int *numCommunities; // communities in each component split
+  if ((numCommunities = new int[numGroups + 1]) == NULL)
+    fatal("memory not allocated");
+  for (int g = 0; g < numGroups; g++)
+    numCommunities[g] = 0;
+
+  for (int i = 0; i < numVertices; i++) {
+    if (size[lowest[i]] == 1)
+      clusterNum[i] = -1; // singleton, or a community of one vertex
+    else if (lowest[i] == i) {
+      clusterNum[i] = numClusters++;
+      if (local[i] >= 0)
+	numCommunities[group[local[i]]]++;
     }
+    else
+      clusterNum[i] = clusterNum[lowest[i]];
   }
 
-  //cout << "v1 = " << v1 << ", v2 = " << v2 << endl;
+  FILE *output;
+  if ((output = fopen(fileName, "w")) == NULL)
+    fatal("Communities file could not be opened");
 
-  if(vertices[v1].haveEdge(v2)) { // edge already exist
-	//	if (weight > vertices[v1].getWeight(v2))
-	//  vertices[v1].changeWeight(v2, weight); // use highest weight for edge
-    return 0; // signal no new edge added
+  fprintf(output, "%d nodes %d clusters %d edges\n", numVertices, numClusters, numEdges);
+  for (int i = 0; i < numVertices; i++)
+    fprintf(output, "%d ", clusterNum[i]);
+  fprintf(output, "\n\n");
+
+  int totalCommunities = 0;
+  fprintf(output, "%d components of %d or more nodes split into communities\n", numGroups, minSize);
+  for (int g = 0; g < numGroups; g++) {
+    int r = groupRoot[g];
+    fprintf(output, "cluster %d: %d nodes split into %d communities, modularity %f\n", groupNum[g], firstMember[r+1] - firstMember[r], numCommunities[g], modularity[g]);
+    totalCommunities += numCommunities[g];
   }
+  fclose(output);
 
-  vertices[v1].addEdge(v2, weight); // add edge
+  cout << numGroups << " components of " << minSize << " or more vertices split into " << totalCommunities << " communities; " << numClusters << " clusters written to '" << fileName << "'" << endl;
 
-  if(RETAINSYMMETRIC) { // retain both (i,j) and (j,i)
-    if(vertices[v2].haveEdge(v1)) // edge already exists, return failure
-      return 0;
-    vertices[v2].addEdge(v1, weight);
+  if (copied) {
+    delete [] fullOffset;
+    delete [] adj;
   }
+  delete [] adjWeight;
+  delete [] root;
+  delete [] firstMember;
+  delete [] members;
+  delete [] local;
+  delete [] vertex;
+  delete [] group;
+  delete [] groupRoot;
+  delete [] groupNum;
+  delete [] subOffset;
+  delete [] subAdj;
+  delete [] subWeight;
+  delete [] community;
+  delete [] modularity;
+  delete [] lowest;
+  delete [] size;
+  delete [] clusterNum;
+  delete [] numCommunities;
+}
 
-  numEdges++; // update number of edges
-  vertices[v1].degree++; // update degree of vertices
-  if (!DIRECTED)
-    vertices[v2].degree++; // increase degree for both vertices if undirected
+int Network::findEdge(int v1, int v2) // index in target of edge, -1 if not in graph
+{
+  if (!finished) fatal("Edges must be finished before they are looked up");
 
-  return 1;
+  int *first = target + offset[v1], *last = target + offset[v1+1]; // row of v1
+  int *found = DIRECTED ? std::find(first, last, v2) : std::lower_bound(first, last, v2); // rows are sorted if undirected
+
+  if ((found == last) || (*found != v2))
+    return -1;
+  return (int)(found - target);
 }
 
 void Network::printEdges(char *outputFile) // print all edges in network
@@ -248,13 +900,10 @@ void Network::printEdges(char *outputFile) // print all edges in network
   for (int i = 0; i < numVertices; i++)
     fprintf(output,"\n  node\n  [\n    id %d\n  ]", i+1);
 
-  fclose(output);
-
   for (int i = 0; i < numVertices; i++)
-    vertices[i].printEdges(i, outputFile);
-
-  if ((output = fopen(outputFile, "a")) == NULL)
-      fatal ("Unable to open output file");
+    for (long int e = offset[i]; e < offset[i+1]; e++)
+      if(!symmetric || (i < target[e])) // print only once
+	fprintf(output,"\n\tedge\n\t[\n\tsource %d\n\ttarget %d\n\t]", i+1, target[e]+1);
 
   fprintf(output,"\n]\n");  
   fclose(output);
@@ -275,14 +924,14 @@ double Network::getEdgeWeight(int v1, int v2) // get weight of edge between endp
     }
   }
 
-  if(!vertices[v1].haveEdge(v2)) // edge is not in graph
-	fatal("Attempt to get weight of edge that is not in graph");
+  if (weight == NULL)
+	fatal("Edge weights were not kept in network");
 
-  double wt = vertices[v1].getWeight(v2); // get weight
-  if (wt < 0-TOL)
-	fatal ("Negative edge weight");
+  int e = findEdge(v1, v2);
+  if(e < 0) // edge is not in graph
+	fatal("Attempt to get weight of edge that is not in graph");
 
-  return wt;
+  return weightValue(weight[e]);
 }
 
 int Network::haveEdge(int v1, int v2) // return 1 if edge is in graph
@@ -300,7 +949,7 @@ int Network::haveEdge(int v1, int v2) // return 1 if edge is in graph
     }
   }
 
-  if(vertices[v1].haveEdge(v2)) // edge is in graph
+  if(findEdge(v1, v2) >= 0) // edge is in graph
     return 1;
   else 
     return 0;
@@ -318,17 +967,15 @@ void Network::bfs(char *outputFile)
   if ((output = fopen(outputFile, "w")) == NULL)
       fatal ("Unable to open output file");
 
-  int ptr; // point to current index of component array
-  int startPtr, endPtr; // pointers for queue
-  int *visited, *component, *queue, *clusterNum;
+  finishEdges(); // no-op if already called
+
+  int ptr; // number of vertices in current component
+  int *component, *clusterNum; // component points into members
   int numSingle = 0; // count nodes with degree zero
   int numTwo = 0; // count number of components with 2 vertices
   int k = 0; // current cluster number
   int totalEdges = 0; // total edges in graph
   int numComp3orMore = 0; // number of components with 3 or more vertices
-  FILE *outputGML; // output components to .gml files
-  FILE *outputWG2; // output components to .wg2 files
-  FILE *outputCompnn; // output node numbering for components
   int randomVal; // random value to place at end of comp file names
   int numNonSingle = 0; // number of non-singleton components
   int printNum = 0; // number of cluster printed out
@@ -340,23 +987,30 @@ void Network::bfs(char *outputFile)
   for (int i = 0; i < 100; i++)
 	num[i] = 0;
 
-  int compSize[MAX_NUM_COMPS]; // hold non-singleton component sizes
-  double compDensity[MAX_NUM_COMPS]; // hold non-singleton component densities
-  int compPtr = 0; // pointer for these two arrays
+  CompStats sizeStats, densityStats; // sizes and densities of non-singleton components
+  startStats(&sizeStats);
+  startStats(&densityStats);
+  int *printRoot = NULL; // lowest vertex of each component to print to files
+
+  if (BFS_GML || BFS_WG2) // at most one for every three vertices
+    if ((printRoot = new int[numVertices/3 + 1]) == NULL)
+      fatal("memory not allocated"); // allocate memory
 
-  if(BFS_WG2 && !RETAINSYMMETRIC) 
+  if(BFS_WG2 && !symmetric) 
     fatal("Need to retain symmetric edges for .wg2 output");
+  if(BFS_GML && !weighted) 
+    fatal("Need to keep edge weights for .gml output");
 
   srand(time(NULL)); // assign random value between 1 - 1000
   randomVal = rand() % 1000 + 1;
 
-  if(((visited = new int[numVertices]) == NULL)||((component = new int[numVertices]) == NULL))
+  if ((clusterNum = new int[numVertices]) == NULL)
     fatal("memory not allocated"); // allocate memory
-  if(((queue = new int[numVertices]) == NULL)||((clusterNum = new int[numVertices]) == NULL))
+
+  int *root, *firstMember, *members; // lowest vertex of each component and members by root
+  if(((root = new int[numVertices]) == NULL) || ((firstMember = new int[numVertices+1]) == NULL) || ((members = new int[numVertices]) == NULL))
     fatal("memory not allocated"); // allocate memory
- 
-  for (int i = 0; i < numVertices; i++) 
-    visited[i] = 0; // initialize values to not visited
+  findComponents(root, firstMember, members);
 
   for (int i = 0; i < numVertices; i++) {
     int degree = getDegree(i);
@@ -367,33 +1021,10 @@ void Network::bfs(char *outputFile)
       continue;
     }
 
-    if (visited[i] == 0) { // unvisited vertex
-      visited[i] = 1;
+    if (root[i] == i) { // lowest vertex of a new component
       numNonSingle++; // another nonsingleton cluster
-      ptr = 0; // start a new component
-      startPtr = 0; // start a new queue
-      queue[0] = i; // first vertex in queue
-      endPtr = 1;
-	  
-      while (startPtr != endPtr) { // while queue is not empty
-		int node = queue[startPtr++]; // remove first vertex on queue
-		component[ptr++] = node; // this vertex is in component
-		visited[node] = 1; // mark as visited
-		
-		Edge *edgePtr; // pointer to move through linked list of edges
-		edgePtr = &(vertices[node].firstEdge); // point to first edge
-		
-		while (edgePtr->next != 0) { // follow until find last edge
-		  edgePtr = edgePtr->next; // pointer points at next edge in list
-		  int endpt = edgePtr->target; // find adjacent vertex 
-		  
-		  if (!visited[endpt]) {
-			visited[endpt] = 1; 
-			queue[endPtr++] = endpt; // add to queue 
-		  }
-		}
-		
-      }
+      component = members + firstMember[i]; // members in increasing order
+      ptr = firstMember[i+1] - firstMember[i];
 	  
       long int numberEdges = 0; // count edges in component
       for (int j = 0; j < ptr; j++)
@@ -411,11 +1042,8 @@ void Network::bfs(char *outputFile)
 		clusterNum[component[j]] = k;
       k++; // move to next cluster number
 	  
-	  if (compPtr == MAX_NUM_COMPS)
-		fatal("MAX_NUM_COMPS exceeded.  Change to larger value in network.h");
-
-	  compSize[compPtr] = ptr; // record component size
-	  compDensity[compPtr++] = complete; // record density
+	  addStat(&sizeStats, ptr); // record component size
+	  addStat(&densityStats, complete); // record density
 
       if (ptr == 2) // only 2 vertices in component
 		numTwo++;
@@ -458,103 +1086,34 @@ void Network::bfs(char *outputFile)
 	maxCompAll = ptr; // keep track of largest component overall
 
       if ((ptr>2) && (BFS_GML || BFS_WG2)) // print out nontrivial components
-		if (complete < MIN_COMPLETE+TOL) { // print only if not too complete
-		  const char base[] = "comp"; // make up new filename for current comp.
-	  const char suffix1[] = ".gml"; 
-	  const char suffix2[] = ".nn";
-	  const char suffix3[] = ".wg2";
-	  char filename [50]; // .gml file
-	  char filenn [50];  // node numbering file
-	  char fileWG2 [50]; //.wg2 file
-	  printNum++; // increase to next cluster printed
-	  //sprintf(filename, "%s%d_%d%s", base, randomVal, printNum, suffix1);
-	  //sprintf(filenn, "%s%d_%d%s", base, randomVal, printNum, suffix2);
-	  //sprintf(fileWG2, "%s%d_%d%s", base, randomVal, printNum, suffix3);
-
-	  sprintf(filename, "%s%d%s", base, printNum, suffix1);
-	  sprintf(filenn, "%s%d%s", base, printNum, suffix2);
-	  sprintf(fileWG2, "%s%d%s", base, printNum, suffix3);
-	  
-	  if(BFS_GML)
-	    if ((outputGML = fopen(filename, "w")) == NULL)
-	      fatal("Component output file could not be opened");
-	  
-	  if ((outputCompnn = fopen(filenn, "w")) == NULL)
-	    fatal("Component node numbering file could not be opened");
-
-	  if(BFS_WG2)
-	    if ((outputWG2 = fopen(fileWG2, "w")) == NULL)
-	      fatal("Component output file could not be opened");
-	  
-	  fprintf(outputCompnn, "%d nodes\n",ptr);
-
-	  for (int j = 0 ; j < ptr; j++) // output node numbering 
-	    fprintf(outputCompnn, "%d ", component[j]);
-	  fprintf(outputCompnn, "\n");
-	  fclose(outputCompnn);
-	  
-	  if(BFS_GML) {
-	    fprintf(outputGML,"Graph with %d nodes and %d edges.\ngraph\n[", ptr, numberEdges);  
-	    
-	    for (int j = 0; j < ptr; j++)
-	      fprintf(outputGML,"\n  node\n  [\n    id %d\n  ]", j+1);
-	    fclose(outputGML);
-	    
-	    if ((outputGML = fopen(filename, "a")) == NULL)
-	      fatal ("Unable to open component output file");
-	  }
+	if (complete < MIN_COMPLETE+TOL) { // print only if not too complete
+	  printRoot[printNum++] = i; // written out below
 
 	  if (ptr > maxSizeComp)
 	    maxSizeComp = ptr; // keep track of largest component printed
-
-	  int *nn; // array to hold node numbering
-	  if((nn = new int[numVertices]) == NULL)
-	    fatal("memory not allocated"); // allocate memory
-	  
-	  for (int j = 0; j < ptr; j++)
-	    nn[j] = -1; // initialize
-	  for (int j = 0; j < ptr; j++)
-	    nn[component[j]] = j; // insert new node numbers
-	  
-	  Edge *edgePtr; // pointer to move through linked list of edges
-	  
-	  for (int j = 0; j < ptr; j++) { // find edges in component
-	    int node = component[j];
-	    edgePtr = &(vertices[node].firstEdge); // point first edge
-	    
-	    if (nn[node] < 0) fatal("Node numbering array error");
-	    if(BFS_WG2)
-	      fprintf(outputWG2,"%d %d, X %d [ ",j, j, vertices[node].degree);  	    
-
-	    while (edgePtr->next != 0) { // follow until find last edge
-	      edgePtr = edgePtr->next; // pointer points at next edge in list
-	      if (nn[edgePtr->target] < 0) fatal("node numbering array error");
-	      
-	      if (BFS_GML)
-		if(!RETAINSYMMETRIC || (node < edgePtr->target)) // print once
-		  fprintf(outputGML,"\n\tedge\n\t[\n\tsource %d\n\ttarget %d\n\tweight %f\n\t]", nn[node]+1, nn[edgePtr->target]+1, edgePtr->weight);
-
-	      if(BFS_WG2)
-		fprintf(outputWG2,"(%d, 1.0) ",nn[edgePtr->target]);
-	    }
-
-	    if(BFS_WG2)
-	      fprintf(outputWG2,"] \n");
-	  }
-	  
-	  //for (int j = 0; j < ptr; j++)
-	  //vertices[component[j]].printEdges(component[j], filename);
-	  
-	  if (BFS_GML) {
-	    fprintf(outputGML,"\n]\n");  
-	    fclose(outputGML);
-	  }
-
-	  if(BFS_WG2)
-	    fclose(outputWG2);
 	}
     }
   }
+
+  if (printNum > 0) { // write component files, a few at a time
+    int *nn; // number of each vertex within its component
+    if((nn = new int[numVertices]) == NULL)
+      fatal("memory not allocated"); // allocate memory
+
+    for (int j = 0; j < numVertices; j++)
+      nn[j] = -1; // initialize
+
+    // components don't share vertices, so threads renumber disjoint parts of nn
+    #pragma omp parallel for schedule(dynamic) num_threads(WRITER_THREADS)
+    for (int p = 0; p < printNum; p++) {
+      int r = printRoot[p]; // lowest vertex of component
+      for (int m = firstMember[r]; m < firstMember[r+1]; m++)
+	nn[members[m]] = m - firstMember[r]; // insert new node numbers
+      writeComponent(p+1, members + firstMember[r], firstMember[r+1] - firstMember[r], nn);
+    }
+
+    delete [] nn;
+  }
   
     //for (int j = 0; j < numVertices; j++)
     //cout << visited[j] << endl;
@@ -575,97 +1134,31 @@ void Network::bfs(char *outputFile)
 
   fprintf(output, "%d singletons, %d components with only 2 vertices,\n%d components with 3 or more vertices\n", numSingle, numTwo, numComp3orMore);
 
-  // compute statistics about nonsingleton component sizes and densities
-  float avgdata = 0.0; // first compute for component sizes
-  float sdata = 0.0;
-  float confUpData, confLowData;
-  float tempData;
-  float median;
-  int size = compPtr;
- 
-  if (size > 1) {
-    for (int i = 0; i < size; i++)   // sort data
-      for (int j = size-1; j > i; j--)
-		if (compSize[j] < compSize[j-1]) {
-		  tempData = compSize[j];
-		  compSize[j] = compSize[j-1];
-		  compSize[j-1] = (int)tempData;
-		}
-    
-    if ((size % 2) == 0)  // an even number of data
-      median = 0.5 * (compSize[size/2] + compSize[size/2 - 1]);
-    
-    else        // odd number of data
-      median = compSize[size/2];
-	
-    for (int i = 0; i < size; i++)     // find mean of data
-      avgdata += compSize[i];
-    avgdata /= (float)size;
-	
-    for (int i = 0; i < size; i++)  // find 95% confidence interval
-      sdata += (compSize[i] - avgdata) * (compSize[i] - avgdata);
-    sdata /= (float)((size - 1) * size);
-    sdata = sqrt(sdata);
-  }
-  
-  else {
-    median = avgdata = compSize[0];
-    sdata = 0;
-  }
-  
-  confUpData = avgdata + (2.0 * sdata);
-  confLowData = avgdata - (2.0 * sdata);
+  // statistics of nonsingleton component sizes and densities, found by
+  // selection rather than sorting
+  double median = statMedian(&sizeStats);
+  double avgdata = statMean(&sizeStats);
+  double halfWidth = statHalfWidth(&sizeStats);
   
   cout << "\nSizes of non-singleton components:" << endl;
-  cout << "\tmax = " << compSize[size-1];
-  cout << ", min = " << compSize[0];
+  cout << "\tmax = " << sizeStats.max;
+  cout << ", min = " << sizeStats.min;
   cout << ", median = " << median;
   cout << ", average = " << avgdata << endl;
-  cout << "\t95% confidence interval: " << confUpData << ", " << confLowData << endl;
+  cout << "\t95% confidence interval: " << avgdata + halfWidth << ", " << avgdata - halfWidth << endl;
 
   float meanSize = avgdata; // save in case PRINTCOMPSIZES
   
-  avgdata = 0.0;  // repeat for component densities
-  sdata = 0.0;
-  if (size > 1) {
-    for (int i = 0; i < size; i++)   // sort data
-      for (int j = size-1; j > i; j--)
-		if (compDensity[j] < compDensity[j-1]) {
-		  tempData = compDensity[j];
-		  compDensity[j] = compDensity[j-1];
-		  compDensity[j-1] = tempData;
-		}
-    
-    if ((size % 2) == 0)  // an even number of data
-      median = 0.5 * (compDensity[size/2] + compDensity[size/2 - 1]);
-    
-    else        // odd number of data
-      median = compDensity[size/2];
-	
-    for (int i = 0; i < size; i++)     // find mean of data
-      avgdata += compDensity[i];
-    avgdata /= (float)size;
-	
-    for (int i = 0; i < size; i++)  // find 95% confidence interval
-      sdata += (compDensity[i] - avgdata) * (compDensity[i] - avgdata);
-    sdata /= (float)((size - 1) * size);
-    sdata = sqrt(sdata);
-  }
-  
-  else {
-    median = avgdata = compDensity[0];
-    sdata = 0;
-  }
-  
-  confUpData = avgdata + (2.0 * sdata);
-  confLowData = avgdata - (2.0 * sdata);
+  median = statMedian(&densityStats); // repeat for component densities
+  avgdata = statMean(&densityStats);
+  halfWidth = statHalfWidth(&densityStats);
   
   cout << "\nDensities of non-singleton components:" << endl;
-  cout << "\tmax = " << compDensity[size-1];
-  cout << ", min = " << compDensity[0];
+  cout << "\tmax = " << densityStats.max;
+  cout << ", min = " << densityStats.min;
   cout << ", median = " << median;
   cout << ", average = " << avgdata << endl;
-  cout << "\t95% confidence interval: " << confUpData << ", " << confLowData << endl;
+  cout << "\t95% confidence interval: " << avgdata + halfWidth << ", " << avgdata - halfWidth << endl;
   cout << endl;
 
   if(1) {
@@ -715,9 +1208,109 @@ void Network::bfs(char *outputFile)
   fclose(compsize);
   }
 
-  delete [] visited;
-  delete [] component;
-  delete [] queue;
+  if(COMP_STATS) { // quantiles and histograms to output.bfs.stats
+    char statsName[500];
+    FILE *stats;
+    sprintf(statsName, "%.490s.stats", outputFile);
+
+    if ((stats = fopen(statsName, "w")) == NULL)
+      fatal("Stats file could not be opened");
+
+    fprintf(stats, "singletons\t%d\n", numSingle);
+    fprintf(stats, "components_2\t%d\n", numTwo);
+    fprintf(stats, "components_3_or_more\t%d\n", numComp3orMore);
+    fprintf(stats, "not_cliques\t%d\n", numNotCliques);
+    writeCompStats(stats, &sizeStats, "size", 1);
+    writeCompStats(stats, &densityStats, "density", 0);
+    fclose(stats);
+  }
+
+  freeStats(&sizeStats);
+  freeStats(&densityStats);
+  delete [] root;
+  delete [] firstMember;
+  delete [] members;
   delete [] clusterNum;
+  delete [] printRoot;
+}
+
+// write component with given print number to compx.nn and, as set in
+// network.h, compx.gml and compx.wg2; nn holds the number of each of its
+// vertices within it
+void Network::writeComponent(int printNum, int *component, int ptr, int *nn)
+{
+  FILE *outputGML; // output component to .gml file
+  FILE *outputWG2; // output component to .wg2 file
+  FILE *outputCompnn; // output node numbering for component
+  const char base[] = "comp"; // make up new filename for current comp.
+  const char suffix1[] = ".gml"; 
+  const char suffix2[] = ".nn";
+  const char suffix3[] = ".wg2";
+  char filename [50]; // .gml file
+  char filenn [50];  // node numbering file
+  char fileWG2 [50]; //.wg2 file
+
+  sprintf(filename, "%s%d%s", base, printNum, suffix1);
+  sprintf(filenn, "%s%d%s", base, printNum, suffix2);
+  sprintf(fileWG2, "%s%d%s", base, printNum, suffix3);
+
+  long int numberEdges = 0; // count edges in component
+  for (int j = 0; j < ptr; j++)
+    numberEdges += getDegree(component[j]);
+  numberEdges /= 2; // count (i,j) and (j,i) only once
+
+  if ((outputCompnn = fopen(filenn, "w")) == NULL)
+    fatal("Component node numbering file could not be opened");
+
+  fprintf(outputCompnn, "%d nodes\n",ptr);
+
+  for (int j = 0 ; j < ptr; j++) // output node numbering 
+    fprintf(outputCompnn, "%d ", component[j]);
+  fprintf(outputCompnn, "\n");
+  fclose(outputCompnn);
+
+  if(BFS_GML) {
+    if ((outputGML = fopen(filename, "w")) == NULL)
+      fatal("Component output file could not be opened");
+
+    fprintf(outputGML,"Graph with %d nodes and %ld edges.\ngraph\n[", ptr, numberEdges);  
+
+    for (int j = 0; j < ptr; j++)
+      fprintf(outputGML,"\n  node\n  [\n    id %d\n  ]", j+1);
+  }
+
+  if(BFS_WG2)
+    if ((outputWG2 = fopen(fileWG2, "w")) == NULL)
+      fatal("Component output file could not be opened");
+
+  for (int j = 0; j < ptr; j++) { // find edges in component
+    int node = component[j];
+
+    if (nn[node] < 0) fatal("Node numbering array error");
+    if(BFS_WG2)
+      fprintf(outputWG2,"%d %d, X %d [ ",j, j, getDegree(node));  	    
+
+    for (long int e = offset[node]; e < offset[node+1]; e++) { // adjacent vertices are contiguous
+      if (nn[target[e]] < 0) fatal("node numbering array error");
+
+      if (BFS_GML)
+	if(!symmetric || (node < target[e])) // print once
+	  fprintf(outputGML,"\n\tedge\n\t[\n\tsource %d\n\ttarget %d\n\tweight %f\n\t]", nn[node]+1, nn[target[e]]+1, weightValue(weight[e]));
+
+      if(BFS_WG2)
+	fprintf(outputWG2,"(%d, 1.0) ",nn[target[e]]);
+    }
+
+    if(BFS_WG2)
+      fprintf(outputWG2,"] \n");
+  }
+
+  if (BFS_GML) {
+    fprintf(outputGML,"\n]\n");  
+    fclose(outputGML);
+  }
+
+  if(BFS_WG2)
+    fclose(outputWG2);
 }
 
@@ -18,73 +18,94 @@
 #include <iostream>
 #include <iomanip>
 #include <time.h>
+#include <algorithm>
 #include "bfsNet.h"
+#include "weights.h"
+#include "frames.h"
+#include "graphfile.h"
+#include "compstats.h"
+#include "cores.h"
+#include "community.h"
 
-const int RETAINSYMMETRIC = 1;// 1 to retain both (i,j) and (j,i) (use for BFS)
+const int RETAINSYMMETRIC = 0;// 1 to retain both (i,j) and (j,i) (needed for .wg2 output)
 const int DESCRIPTIVE_OUTPUT = 0; // 0 for just cluster membership numbers
 const int PRINTCOMPSIZES = 0; // 1 to print summary of component sizes out to "saveCompSizes.txt"
+const int COMP_STATS = 0; // 1 to write quantiles and histograms of component sizes and densities to output.bfs.stats
 const int BFS_GML = 0; // 1 to output BFS components to .gml files
 const int BFS_WG2 = 0; // 1 to output BFS components to .wg2 files
 const double MIN_COMPLETE = -1.0; // print comp. only if less than this value (0.5)
-const int MAX_NUM_COMPS = 500000; // max number of non-singleton components
+const int WRITER_THREADS = 4; // max threads writing component files at once
 const double TOL = 0.000001; // tolerance
+const int STAGE_SHIFT = 20; // blocks of staging arena hold 2^STAGE_SHIFT edges
+const int LINK_ROUNDS = 2; // neighbours of each vertex linked before sampling for giant component
+const int COMP_SAMPLES = 1024; // vertices sampled to find giant component
+const int CORE_MIN_SIZE = 10; // smallest component given core numbers and cliques (--cores)
+const int MIN_CLIQUE = 3; // smallest maximal clique listed (--cliques)
+const int COMMUNITY_MIN_SIZE = 1000; // smallest component split into communities (--communities)
 
-class Edge
+struct StagedEdge // edge waiting to be sorted into adjacency arrays
 {
-  friend class Vertex; // Vertex class allowed access to private data
-  friend class Network; 
-private: 
-  Edge(int = 0, double = 1); // create a new edge with default weight of 1
-  int getTarget(); // get other edgepoint  
-  double getWeight(); // get weight of edge 
-  int target; // other edgepoint
-  double weight; // weight 
-  Edge *next; // pointer to next edge eminating from source vertex
+  int v1, v2; // endpoints (v1 < v2 if undirected)
+  unsigned short weight; // weight, quantised (see weights.h)
 };
 
-class Vertex
-{
-  friend class Network; // Network class allowed access to private functions
- private:
-  Vertex(); // create a new vertex
-  ~Vertex(); // destructor
-  int index; // index number of node
-  int degree; // out-degree of vertex (full degree for undirected)
-  Edge firstEdge; // first edge eminating from vertex
-  //int ID; // GML ID number of vertex
-  //char *label; // GML label of vertex (NULL if none specified)
-
-  int addEdge(int, double=1); // add an edge to vertex, return 1 if successful
-  int haveEdge(int); // check to see if edge already exists, return 0 if not
-  double getWeight(int); // return weight of edge
-  void changeWeight(int, double); // change weight of edge
-  int getDegree(); // get out-degree of vertex (full degree for undirected)
-  Edge* getEdges(); // get copy of edges eminating from vertex
-  void printEdges(int, char *); // print edges eminating from vertex
-  //int getID(); // get GML ID number of vertex (-1 if none specified)
-  //char *getLabel(); // get GML label of vertex (NULL if none specified)
-};
+// Storage per edge is 4 bytes for the target and 2 for the weight in
+// each direction that is kept.  Components are found in parallel by
+// linking the roots of a union-find structure (Afforest), which works
+// with or without the reverse (j,i) entries.
+// Edges are staged in fixed-size blocks, so the staging area never has
+// to be copied to grow.
 
 class Network
 {
  public:
-  Network(int = 0, int = 0); // create a network with 0 vertices
+  Network(int = 0, int = 0, int = RETAINSYMMETRIC, int = 1); // vertices, directed, keep (j,i) entries, keep weights
   ~Network(); // destructor
   int getNvertices(); // get number of vertices in network
   int getNumEdges(); // get number of edges in network
   int getDegree(int); // get degree of vertex
   int isDirected(); // return 0 if undirected, 1 if directed network
-  int addEdge(int, int, double=1); // return 1 if edge successfully added
+  int addEdge(int, int, double=1); // stage edge for finishEdges, return 1
+  int finishEdges(); // build adjacency arrays, return number of duplicate edges dropped
+  void mapEdges(GraphFile *); // use arrays of mapped graph file instead of adding edges
+  int saveGraph(char *, int *, int); // write graph file, given node ids and TWONODE flag, return 1 if successful
   int haveEdge(int, int); // return 1 if edge is in graph
   void printEdges(char *); // print all edges in network
   void bfs(char *); // breadth-first search outputs connected components
+  void dendrogram(char *, double *, int); // write merges of maximum spanning forest and clusters at given thresholds
+  void cores(char *, int, double); // write core numbers of components of at least given size, and their maximal cliques if given seconds > 0
+  void communities(char *, int); // write clusters with components of at least given size split into communities
   double getEdgeWeight(int, int); // return weight of edge, given endpoints
 
  private:
+  int findEdge(int, int); // index in target of edge, -1 if not in graph
+  StagedEdge *stagedEdge(long int); // staged edge with given index
+  void findComponents(int *, int *, int *); // root (lowest vertex), first member of each root and members
+  void link(int, int, int *); // join components of two vertices in root array
+  void compress(int *); // point every vertex of root array at its root
+  int fullRows(long int **, int **, double **); // rows with (i,j) and (j,i) entries and their weights, return 1 if rows were copied
+  void writeComponent(int, int *, int, int *); // write component files, given print number, vertices, size and numbering
+
   int numVertices; // number of vertices
   int directed; // 0 if undirected, 1 if directed
   int numEdges; // number of edges
-  Vertex *vertices; // vertices in network
+  int *degree; // out-degree of each vertex (full degree for undirected)
+  int symmetric; // 1 to keep both (i,j) and (j,i) entries (Boolean)
+  int weighted; // 1 to keep edge weights (Boolean)
+
+  // edges are loaded in two phases: addEdge appends them to a flat array,
+  // and finishEdges sorts it, drops duplicates (keeping the highest
+  // weight) and builds compressed sparse row (CSR) adjacency arrays
+  StagedEdge **block; // blocks of staging arena
+  int numBlocks; // number of blocks allocated
+  int capBlocks; // number of block pointers allocated
+  long int numStaged; // number of staged edges
+  int finished; // 1 once adjacency arrays are built (Boolean)
+  int mapped; // 1 if adjacency arrays are those of a mapped graph file (Boolean)
+
+  long int *offset; // adjacent vertices of v are target[offset[v]] to target[offset[v+1]-1]
+  int *target; // adjacent vertices (in increasing order for each vertex if undirected)
+  unsigned short *weight; // weight of each entry of target, quantised (NULL if not kept)
 };
 
 #endif
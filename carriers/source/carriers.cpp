@@ -16,6 +16,7 @@
 
 
 #include "carriers.h"
+#include "genotypes.h"
 
 using namespace std;
 
@@ -209,10 +210,9 @@ int main(int argc, char ** argv)
   // allocate memory
   int *numCase; // hold number of Cases with the cluster
   int *numCtrl;  // hold number of Controls with the cluster
-  int *alleles; // hold the alleles for the current individual
-  int **allelePairs; // hold ASCII values of alleles for each SNP
   int *numCase_noMissData; // hold number of cases that have no missing data for the SNPs in the cluster
   int *numCtrl_noMissData; // hold number of controls that have no missing data for the SNPs in the cluster
+  char (*allele)[2]; // the two alleles of each SNP, in alphabetical order
 
   if ((numCase = new int [numClusters]) == NULL)
     fatal("Memory not allocated");
@@ -220,523 +220,103 @@ int main(int argc, char ** argv)
   if ((numCtrl = new int [numClusters]) == NULL)
     fatal("Memory not allocated");
 
-  if ((alleles = new int [numAlleles]) == NULL)
+  if ((allele = new char[numSnps][2]) == NULL)
     fatal("Memory not allocated");
 
-  if ((allelePairs = new int*[numSnps]) == NULL)
-    fatal("Memory not allocated");
-
-  for (int i = 0; i < numSnps; i++) // for each SNP, record two alleles
-    if ((allelePairs[i] = new int [2]) == NULL)
-      fatal("Memory not allocated");
-
   if ((numCase_noMissData = new int [numClusters]) == NULL)
     fatal("Memory not allocated");
 
   if ((numCtrl_noMissData = new int [numClusters]) == NULL)
     fatal("Memory not allocated");
 
-  for (int i = 0; i < numClusters; i++) { // initialize arrays
-    numCase[i] = 0;
-    numCtrl[i] = 0;
-    numCase_noMissData[i] = 0;
-    numCtrl_noMissData[i] = 0;
-  }
-  
-  for (int i = 0; i < numSnps; i++)  // initialize allelePairs
-    for (int j  = 0; j < 2; j++)
-      allelePairs[i][j] = -1;
-  
-  // determine format and the allele pair for each SNP, look at Controls file first
-  if ((ctrl = fopen(argv[3], "r")) == NULL)
-    fatal("Input file could not be opened.\n");
-
-  int space = 0; // set to 1 if space between alleles in ctrl
-  int slash = 0; // set to 1 if slash mark between alleles in ctrl
-  int format = 0; // set to 1 once format is determined
+  for (int i = 0; i < numSnps; i++)  // no alleles found yet
+    allele[i][0] = allele[i][1] = '0';
 
-  int ascii1, ascii2; // temporary values to hold alleles as they are read
+  // genotypes are read with the functions ccc uses, so alleles are
+  // coded the same way as the nodes of the clusters
+  GenotypeText caseText, ctrlText; // genotype files mapped into memory
+  GenotypeLayout caseLayout = {nCase, numSnps, numHeadRowsGen, numHeadColsGen, 0};
+  GenotypeLayout ctrlLayout = {nCtrl, numSnps, numHeadRowsGen, numHeadColsGen, 0};
+  char error[200]; // reason genotypes couldn't be read
+  char message[250];
 
-  // read in header rows and disregard
-  for (int i = 0; i < numHeadRowsGen; i++)
-    for (int j = 0; j < numHeadColsGen + numSnps; j++)
-      fscanf(ctrl, "%s", strng); 
-
-  // read in data
-  for (int i = 0; i < nCtrl; i++) {
-    if (format)
-      break; // already determined format
-
-    for (int j = 0; j < numHeadColsGen; j++) 
-      fscanf(ctrl, "%s", strng); // read in and disregard header columns
-
-    for (int j = 0; j < numSnps; j++) {
-      if(feof(ctrl))
-	fatal("ctrl file is missing data");
-
-      fscanf(ctrl, "%s", strng);
-      //cout << i << ", " << j << ": " << strng << endl;
-
-      num = strng[0]; // find ascii value of first char
+  if (!mapText(argv[2], &caseText) || !mapText(argv[3], &ctrlText))
+    fatal("Input file could not be opened.\n");
 
-      if ((num != 48) && (num != 78)) // not 'N' or '0'
-	if ((num != 63) && (num != 88)) { // not '?' or 'X'
-	
-	  if ((int)strng[1] == 47) // second char is a '/'
-	    slash = 1;
-	  
-	  else if ((int)strng[1] < 65) // second char is not a letter
-	    space = 1; // space between chars
-	  
-	  format = 1;
-	  break; // determined format
-	}
-    }
+  // determine the allele pair for each SNP, look at Controls file first
+  if (!findAlleles(ctrlText.data, ctrlText.size, &ctrlLayout, allele, error)) {
+    sprintf(message, "%s in control file", error);
+    fatal(message);
   }
 
-  // reread file and determine alleles for each SNP
-
-  rewind(ctrl); // start over at beginning of file
-
-  // read in header rows and disregard
-  for (int i = 0; i < numHeadRowsGen; i++)
-    for (int j = 0; j < numHeadColsGen + numSnps; j++)
-      fscanf(ctrl, "%s", strng); 
-  
-  // read in data for alleles Ctrl
-  for (int i = 0; i < nCtrl; i++) {
-    for (int j = 0; j < numHeadColsGen; j++) 
-      fscanf(ctrl, "%s", strng); // read in and disregard header columns
-
-    for (int j = 0; j < numSnps; j++) {
-      if(feof(ctrl))
-	fatal("Ctrl file is missing data");
-
-      fscanf(ctrl, "%s", strng);
-      //cout << i << ", " << j << ": " << strng << endl;
-
-      ascii1 = strng[0]; // find ascii value of first char
-
-      if (space) {
-	fscanf(ctrl, "%s", strng); // read in second allele
-	ascii2 = strng[0]; // find ascii value of first char
-	
-      }
-      
-      if (!space) { // no space, so second allele is in current string
-	if (slash) 
-	  ascii2 = strng[2]; // second allele is third char, after '/'
-	else
-	  ascii2 = strng[1]; // second allele is second char
-
-	if ((ascii1 == 48) || (ascii1 == 78)) // missing data
-	  ascii2 = 78; // set to missing as might have 'NA' in input
-      }
-      
-      // check validity of data
-      if ((ascii1 != 65) && (ascii1 != 67)) // not 'A' or 'C'
-	if ((ascii1 != 71) && (ascii1 != 84))  // not 'G' or 'T' 
-	  if ((ascii1 != 73) && (ascii1 != 68))  // not 'I' or 'D'
-	    if ((ascii1 != 48) && (ascii1 != 78))  // not 'N' or '0'
-	      if ((ascii1 != 63) && (ascii1 != 88)) { // not '?' or 'X'
-		cout << (char)ascii1 << endl;
-		fatal("Improper input data in control file");
-	      }
-      
-      if ((ascii2 != 65) && (ascii2 != 67)) // not 'A' or 'C'
-	if ((ascii2 != 71) && (ascii2 != 84))  // not 'G' or 'T' 
-	  if ((ascii2 != 73) && (ascii2 != 68))  // not 'I' or 'D'
-	    if ((ascii2 != 48) && (ascii2 != 78)) // not 'N' or '0'
-	      if ((ascii1 != 63) && (ascii1 != 88)) { // not '?' or 'X'
-		cout << (char)ascii2 << endl;
-		fatal("Improper input data in control file");
-	      }
-      
-      // determine alleles for each genotype
-      if ((ascii1 != 48) && (ascii1 != 78))  // not 'N' or '0'
-	if ((ascii1 != 63) && (ascii1 != 88)) { // not '?' or 'X'
-	  if(allelePairs[j][0] == -1) // '0' so haven't found first allele yet
-	    allelePairs[j][0] = (char)ascii1;
-	  else if (allelePairs[j][1] == -1) // '0' so haven't found second allele yet
-	    if (ascii1 != (int)allelePairs[j][0])
-	      allelePairs[j][1] = (char)ascii1; // found second allele
-	  
-	  if (allelePairs[j][1] == -1) // '0' so haven't found second allele yet
-	    if (ascii2 != (int)allelePairs[j][0])
-	      allelePairs[j][1] = (char)ascii2; // found second allele
-	  
-	  //cout << (char)ascii1 << (char)ascii2 << " "; 
-	  //cout << allele[j][0] << allele[j][1] << endl;
-	}
-    }
+  if (!findAlleles(caseText.data, caseText.size, &caseLayout, allele, error)) {
+    sprintf(message, "%s in case file", error);
+    fatal(message);
   }
-  
-  fclose(ctrl); // close for now, will reopen to read genotypes
-
-  if (((cases = fopen(argv[2], "r")) == NULL))
-    fatal("Input file could not be opened.\n");
-
-   // read in header rows and disregard
-  for (int i = 0; i < numHeadRowsGen; i++)
-    for (int j = 0; j < numHeadColsGen + numSnps; j++)
-      fscanf(cases, "%s", strng); 
-
-  // read in data for alleles cases
-  for (int i = 0; i < nCase; i++) {
-    for (int j = 0; j < numHeadColsGen; j++) 
-      fscanf(cases, "%s", strng); // read in and disregard header columns
 
-    for (int j = 0; j < numSnps; j++) {
-      if(feof(cases))
-	fatal("Case file is missing data");
+  sortAlleles(allele, numSnps);
 
-      fscanf(cases, "%s", strng);
-      //cout << i << ", " << j << ": " << strng << endl;
+  int numMono = 0; // number of mono-allelic SNPs
 
-      ascii1 = strng[0]; // find ascii value of first char
-
-      if (space) {
-	fscanf(cases, "%s", strng); // read in second allele
-	ascii2 = strng[0]; // find ascii value of first char
-	
-      }
-      
-      if (!space) { // no space, so second allele is in current string
-	if (slash) 
-	  ascii2 = strng[2]; // second allele is third char, after '/'
-	else
-	  ascii2 = strng[1]; // second allele is second char
-
-	if ((ascii1 == 48) || (ascii1 == 78)) // missing data
-	  ascii2 = 78; // set to missing as might have 'NA' in input
-      }
-      
-      // check validity of data
-      if ((ascii1 != 65) && (ascii1 != 67)) // not 'A' or 'C'
-	if ((ascii1 != 71) && (ascii1 != 84))  // not 'G' or 'T' 
-	  if ((ascii1 != 73) && (ascii1 != 68))  // not 'I' or 'D'
-	    if ((ascii1 != 48) && (ascii1 != 78))  // not 'N' or '0'
-	      if ((ascii1 != 63) && (ascii1 != 88)) { // not '?' or 'X'
-		cout << (char)ascii1 << endl;
-		fatal("Improper input data in case file");
-	      }
-      
-      if ((ascii2 != 65) && (ascii2 != 67)) // not 'A' or 'C'
-	if ((ascii2 != 71) && (ascii2 != 84))  // not 'G' or 'T' 
-	  if ((ascii2 != 73) && (ascii2 != 68))  // not 'I' or 'D'
-	    if ((ascii2 != 48) && (ascii2 != 78)) // not 'N' or '0'
-	      if ((ascii1 != 63) && (ascii1 != 88)) { // not '?' or 'X'
-		cout << (char)ascii2 << endl;
-		fatal("Improper input data in case file");
-	      }
-      
-      // determine alleles for each genotype
-      if ((ascii1 != 48) && (ascii1 != 78))  // not 'N' or '0'
-	if ((ascii1 != 63) && (ascii1 != 88)) { // not '?' or 'X'
-	  if(allelePairs[j][0] == -1) // '0' so haven't found first allele yet
-	    allelePairs[j][0] = (char)ascii1;
-	  else if (allelePairs[j][1] == -1) // '0' so haven't found second allele yet
-	    if (ascii1 != (int)allelePairs[j][0])
-	      allelePairs[j][1] = (char)ascii1; // found second allele
-	  
-	  if (allelePairs[j][1] == -1) // '0' so haven't found second allele yet
-	    if (ascii2 != (int)allelePairs[j][0])
-	      allelePairs[j][1] = (char)ascii2; // found second allele
-	  
-	  //cout << (char)ascii1 << (char)ascii2 << " "; 
-	  //cout << allele[j][0] << allele[j][1] << endl;
-	}
-    }
-  }
-  
-  fclose(cases); // close for now, will reopen to read genotypes
-
-  int numMono = 0; // number of mono-allelic SNPs in Controls
-  
-  // sort allele pairs alphabetically and check for legitimate values
   for (int i = 0; i < numSnps; i++) {
-    for (int j = 0; j < 2; j++) {
-      num = allelePairs[i][j];
-	  //cout << num << endl;
-      if (num == -1) {
-		if (j == 0)
-		  fatal("Invalid allele value");
-		else {
-		  numMono++; // a mono-allelic SNP
-		  num = allelePairs[i][1] = allelePairs[i][0]; // both alleles the same
-		}
-      }
-	  
-      if ((num != 65) && (num != 67))  // not 'A' or 'C'
-        if ((num != 73) && (num != 68)) // not 'D' or 'I'
-		if ((num != 71) && (num != 84))  { // not 'G' or 'T'
-		  cout << i << ", " << j << ": " << (char)allelePairs[i][j] << endl;
-		  fatal("improper SNP input data");
-		}
-    }
-	
-    if (allelePairs[i][0] > allelePairs[i][1]) { // not in alphabetical order
-      int temp = allelePairs[i][0];  // switch
-      allelePairs[i][0] = allelePairs[i][1];
-      allelePairs[i][1] = temp;
-    }
+    if (allele[i][1] == '0') // no genotypes for SNP
+      fatal("Invalid allele value");
+    if (allele[i][0] == '0')
+      numMono++; // a mono-allelic SNP
   }
   
   if (VERBOSE) {
     cout << "Allele Pairs:" << endl;
     for (int i = 0; i < numSnps; i++)
-      cout << (char)allelePairs[i][0] << " / " << (char)allelePairs[i][1]  << endl;
+      cout << allele[i][0] << " / " << allele[i][1]  << endl;
     cout << endl;
   }
 
   if (numMono > 0) {
-    cout << numMono << " mono-allelic SNPs in Controls data" << endl;
+    cout << numMono << " mono-allelic SNPs in data" << endl;
   }
 
-  int missing; // set to 1 if missing data
-  int numMissing = 0; // count number of missing values
- 
-  // read in Cases genotypes and tally those who have the allele clusters
-  if ((cases = fopen(argv[2], "r")) == NULL)
-    fatal("Input file could not be opened.\n");
+  // record genotype codes of Cases and Controls
+  char **caseRow; // codes of Cases for each SNP
+  char **ctrlRow; // codes of Controls for each SNP
 
-  // read in header rows and disregard
-  for (int i = 0; i < numHeadRowsGen; i++)
-    for (int j = 0; j < numHeadColsGen + numSnps; j++)
-      fscanf(cases, "%s", strng);
-  
-  for (int i = 0; i < nCase; i++) { // read in each individual's gentypes
-    for (int j = 0; j < numAlleles; j++) // initialize array
-      alleles[j] = 0; // number of alleles for this individual
-    
-    for (int j = 0; j < numHeadColsGen; j++)
-      fscanf(cases, "%s", strng); // read in header columns and throw away
-    
-    for (int j = 0; j < numSnps; j++) { // input has SNPs in the columns
-      missing = 0; // intialize flag
-      fscanf(cases, "%s", strng); // read in first allele for the genotype
-      ascii1 = strng[0];
-      //cout << num << " ";
-      
-      if ((ascii1 != 48) && (ascii1 != 78)) { // don't use 'N' or '0' -- missing data
-	if(ascii1 == allelePairs[j][0])  // lowest alphabetically-ordered allele
-	  alleles[j]++;  // individual has this allele
-	else {
-	  if (ascii1 != allelePairs[j][1]) {
-	    cout << "(" << i << "," << j << ") " << (char)ascii1 << ": " ;
-	    cout << (char)allelePairs[j][0] << ", " << (char)allelePairs[j][1] << endl; 
-	    fatal("Invalid allele in Cases genotype file");
-	  }
-	  alleles[j + numSnps]++; // individual has an allele with highest alphabetic order
-	}	  
-      }
-      
-      else { // missing data
-	missing = 1; // set missing flag
-	alleles[j] = alleles[j+numSnps] = -1; // mark as missing
-      }
-      
-      if (space) {
-	fscanf(cases, "%s", strng); // read in second allele
-	ascii2 = strng[0]; // find ascii value of first char
-	
-      }
-      
-      if (!space) { // no space, so second allele is in current string
-	if (slash) 
-	  ascii2 = strng[2]; // second allele is third char, after '/'
-	else
-	  ascii2 = strng[1]; // second allele is second char
-
-	if ((ascii1 == 48) || (ascii1 == 78)) // missing data
-	  ascii2 = 78; // set to missing as might have 'NA' in input
-      }
-      
-      if ((ascii2 != 48) && (ascii2 != 78)) { // don't use 'N' or '0' -- missing data
-	if(ascii2 == allelePairs[j][0])  // lowest alphabetically-ordered allele
-	  alleles[j]++;  // individual has this allele
-	else {
-	  if (ascii2 != allelePairs[j][1]) {
-	    cout << "(" << i << "," << j << ") " << (char)ascii2 << ": " ;
-	    cout << (char)allelePairs[j][0] << ", " << (char)allelePairs[j][1] << endl; 
-	    fatal("Invalid allele in Cases genotype file");
-	  }
-	  alleles[j + numSnps]++; // individual has an allele with highest alphabetic order
-	}
-      }
-      
-      else if (!missing)
-	fatal("One allele missing and other one isn't");
-    }
-    
-    if (0) {
-      cout << "Alleles for case " << i+1 << endl;
-      for (int j = 0; j < numAlleles; j++) 
-	cout << alleles[j]  << " " ;
-      cout << endl;
-    }
-    
-    // check each cluster
-    for (int j = 0; j < numClusters; j++) {
-      int score = 0; // score for this cluster for this individual
-      int flag = 1; // set to 0 if individual does not have this cluster
-      int totalDiff = 0; // number that are different
-      int numMissing = 0; // number that are different due to missing values
-      
-      for (int k = 0; k < clustSize[j]; k++)
-	if (alleles[clusts[j][k]] > 0) { // individual has this allele
-	  score += alleles[clusts[j][k]]; // add number of alleles for this cluster
-	}
-      
-	else { // individual doesn't have this allele
-	  flag = 0; // this individual doesn't have the allele
+  if (((caseRow = new char*[numSnps]) == NULL) || ((ctrlRow = new char*[numSnps]) == NULL))
+    fatal("Memory not allocated");
 
-	  if (alleles[clusts[j][k]] == -1)
-	    numMissing++; // miss is due to missing data
-	}
-      
-      if (flag == 1)
-	numCase[j]++; // another individual with this cluster
-
-      // check if individual has missing data for this pattern
-      int missFlag = 0; // set to one if missing some of the pattern data
-      for (int k = 0; k < clustSize[j]; k++)
-	if (alleles[clusts[j][k]] < 0)  // missing data
-	  missFlag++; // increment number of missing alleles
-      if (missFlag == 0) // none missing
-	numCase_noMissData[j]++; // increment # of ind. w/ no missing data
-    }
+  for (int i = 0; i < numSnps; i++)
+    if (((caseRow[i] = new char[nCase]) == NULL) || ((ctrlRow[i] = new char[nCtrl]) == NULL))
+      fatal("Memory not allocated");
+
+  if (!encodeGenotypes(caseText.data, caseText.size, &caseLayout, allele, caseRow, error)) {
+    sprintf(message, "%s in case file", error);
+    fatal(message);
   }
 
-  // check for end of file
-  if (!feof(cases)){
-    fscanf(cases, "%s", strng);
-    if (!feof(cases))
-      fatal("Unread data in input file");
+  if (!encodeGenotypes(ctrlText.data, ctrlText.size, &ctrlLayout, allele, ctrlRow, error)) {
+    sprintf(message, "%s in control file", error);
+    fatal(message);
   }
-  
-  fclose(cases);
 
-// read in Controls genotypes and tally those who have the allele clusters
- if ((ctrl = fopen(argv[3], "r")) == NULL)
-    fatal("Input file could not be opened.\n");
+  unmapText(&caseText);
+  unmapText(&ctrlText);
 
-  // read in header rows and disregard
-  for (int i = 0; i < numHeadRowsGen; i++)
-    for (int j = 0; j < numHeadColsGen + numSnps; j++)
-      fscanf(ctrl, "%s", strng);
-  
-  for (int i = 0; i < nCtrl; i++) { // read in each individual's gentypes
-    for (int j = 0; j < numAlleles; j++) // initialize array
-      alleles[j] = 0; // number of alleles for this individual
-    
-    for (int j = 0; j < numHeadColsGen; j++)
-      fscanf(ctrl, "%s", strng); // read in first 6 columns and throw away
-    
-    for (int j = 0; j < numSnps; j++) { // input has SNPs in the columns
-      missing = 0; // intialize flag
-      fscanf(ctrl, "%s", strng); // read in first allele for the genotype
-      ascii1 = strng[0];
-      //cout << num << " ";
-      
-      if ((ascii1 != 48) && (ascii1 != 78)) { // don't use 'N' or '0' -- missing data
-	if(ascii1 == allelePairs[j][0])  // lowest alphabetically-ordered allele
-	  alleles[j]++;  // individual has this allele
-	else {
-	  if (ascii1 != allelePairs[j][1]) {
-	    cout << "(" << i << "," << j << ") " << (char)ascii1 << ": " ;
-	    cout << (char)allelePairs[j][0] << ", " << (char)allelePairs[j][1] << endl; 
-	    fatal("Invalid allele in ctrl genotype file");
-	  }
-	  alleles[j + numSnps]++; // individual has an allele with highest alphabetic order
-	}	  
-      }
-      
-      else { // missing data
-	missing = 1; // set missing flag
-	alleles[j] = alleles[j+numSnps] = -1; // mark as missing
-      }
-      
-      if (space) {
-	fscanf(ctrl, "%s", strng); // read in second allele
-	ascii2 = strng[0]; // find ascii value of first char
-	
-      }
-      
-      if (!space) { // no space, so second allele is in current string
-	if (slash) 
-	  ascii2 = strng[2]; // second allele is third char, after '/'
-	else
-	  ascii2 = strng[1]; // second allele is second char
-
-	if ((ascii1 == 48) || (ascii1 == 78)) // missing data
-	  ascii2 = 78; // set to missing as might have 'NA' in input
-      }
-      
-      if ((ascii2 != 48) && (ascii2 != 78)) { // don't use 'N' or '0' -- missing data
-	if(ascii2 == allelePairs[j][0])  // lowest alphabetically-ordered allele
-	  alleles[j]++;  // individual has this allele
-	else {
-	  if (ascii2 != allelePairs[j][1]) {
-	    cout << "(" << i << "," << j << ") " << (char)ascii2 << ": " ;
-	    cout << (char)allelePairs[j][0] << ", " << (char)allelePairs[j][1] << endl; 
-	    fatal("Invalid allele in ctrl genotype file");
-	  }
-	  alleles[j + numSnps]++; // individual has an allele with highest alphabetic order
-	}
-      }
+  // list the alleles of each cluster, cluster by cluster
+  int *first; // index in members of first allele of each cluster
+  int *members; // alleles of each cluster
 
-      else if (!missing)
-	fatal("One allele missing and other one isn't");
-    }
-	
-    if (0) {
-      cout << "Alleles for control " << i+1 << endl;
-      for (int j = 0; j < numAlleles; j++) 
-		cout << alleles[j]  << " " ;
-      cout << endl;
-    }
-	
-    // check each cluster
-    for (int j = 0; j < numClusters; j++) {
-      int score = 0; // score for this cluster for this individual
-      int flag = 1; // set to 0 if individual does not have this cluster
-      int totalDiff = 0; // number that are different
-      int numMissing = 0; // number that are different due to missing values
-      
-      for (int k = 0; k < clustSize[j]; k++)
-	if (alleles[clusts[j][k]] > 0) { // individual has this allele
-	  score += alleles[clusts[j][k]]; // add number of alleles for this cluster
-	}
-      
-	else { // individual doesn't have this allele
-	  flag = 0; // this individual doesn't have the allele
-	  
-	  if (alleles[clusts[j][k]] == -1)
-	    numMissing++; // miss is due to missing data
-	}
-      
-      if (flag == 1) 
-	numCtrl[j]++; // another individual with this cluster
-   
-      // check if individual has missing data for this pattern
-      int missFlag = 0; // set to one if missing some of the pattern data
-      for (int k = 0; k < clustSize[j]; k++)
-	if (alleles[clusts[j][k]] < 0)  // missing data
-	  missFlag++; // increment number of missing alleles
-      if (missFlag == 0) // none missing
-	numCtrl_noMissData[j]++; // increment # of ind. w/ no missing data
-    }
-  }
-  
-  // check for end of file
-  if (!feof(ctrl)){
-    fscanf(ctrl, "%s", strng);
-    if (!feof(ctrl))
-      fatal("Unread data in input file");
+  if (((first = new int[numClusters + 1]) == NULL) || ((members = new int[numAlleles]) == NULL))
+    fatal("Memory not allocated");
+
+  first[0] = 0;
+  for (int i = 0; i < numClusters; i++) {
+    for (int j = 0; j < clustSize[i]; j++)
+      members[first[i] + j] = clusts[i][j];
+    first[i+1] = first[i] + clustSize[i];
   }
 
-  fclose(ctrl);
+  // tally the individuals who have the allele clusters
+  countCarriers(caseRow, numSnps, 0, nCase, first, members, numClusters, numCase, numCase_noMissData);
+  countCarriers(ctrlRow, numSnps, 0, nCtrl, first, members, numClusters, numCtrl, numCtrl_noMissData);
 
   // output clusters
 
@@ -831,11 +411,11 @@ int main(int argc, char ** argv)
 	  if (snpNum >= numSnps) // check for valid number
 	    fatal("SNP number too high");
 	  
-	  fprintf(output,"%d\t%c\t",snpNum+1,(char)allelePairs[snpNum][1]);
+	  fprintf(output,"%d\t%c\t",snpNum+1,allele[snpNum][1]);
 	}
 	
 	else // first allele alphabetically
-	  fprintf(output,"%d\t%c\t",snpNum+1,(char)allelePairs[snpNum][0]);
+	  fprintf(output,"%d\t%c\t",snpNum+1,allele[snpNum][0]);
 	
 	for (int k = 0; k < numColsInfo; k++)
 	  //fprintf(output,"%d\t",clusts[i][j]);		  
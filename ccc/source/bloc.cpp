@@ -12,18 +12,192 @@
   
 
 #include "bloc.h"
+#include "sparse.h"
+#include "checkpoint.h"
+#include "progress.h"
+#include "exact.h"
+#include "tile.h"
+#include "components.h"
+#include "permute.h"
+#include "groups.h"
+#include "positions.h"
+#include "prefilter.h"
+#include "weights.h"
+#include "frames.h"
+#include "genotypes.h"
 
 using namespace std;
 
-void format(char*, char**, char**, char**, double**, double**, int, int, int, int, int, int, char*, int, int, int); // read in and format input data 
+void format(char*, char**, char**, SparseSnp*, SparseSnp*, float, char (*)[2], FreqVec*, FreqVec*, int, int, int, int, int, int, char*, int, int, int); // read in and format input data 
 
 void checkConstants(); // check validity of constants in bloc.h
 
+void reportPermutations(const char*, PermResult*, int, float, unsigned long int, FILE*); // summarize null distribution
+
+void printEdge(FILE*, FILE*, int, int, float, int, long int*, long int*, UnionFind*, int, FrameWriter*); // print edge to output file
+
 
 int main(int argc, char ** argv)
 {
-  if (argc != 8)
-    fatal("Usage:\n\n   ccc input.txt output.gml threshold numInd numSNPs numHeaderRows numHeaderCols\n\n");  
+  // optional arguments start with '--' and follow the required ones
+  int numArgs = argc; // number of arguments before optional ones
+  for (int i = 1; i < argc; i++)
+    if (strncmp(argv[i], "--", 2) == 0) {
+      numArgs = i;
+      break;
+    }
+
+  if (numArgs != 8)
+    fatal("Usage:\n\n   ccc input.txt output.gml threshold numInd numSNPs numHeaderRows numHeaderCols [--exact] [--resume] [--checkpoint seconds] [--progress seconds] [--components output.bfs] [--no-gml] [--binary] [--framed] [--log base] [--permutations N] [--seed seed] [--groups groups.txt]\n       [--positions snp_info.txt numCols numHeadRows (--window bp | --cross-chromosome)]\n       [--minhash | --subsample numInd [--margin m]] [--audit rows]\n\n");  
+
+  int resume = 0; // 1 to continue from last checkpoint (Boolean)
+  int exact = 0; // 1 to evaluate CCC values with integer arithmetic (Boolean)
+  int ckptInterval = CHECKPOINT_INTERVAL; // seconds between checkpoints
+  int progInterval = PROGRESS_INTERVAL; // seconds between progress reports
+  char *compName = NULL; // .bfs file for components found during run
+  int gml = 1; // 0 to skip writing edges to output .gml file (Boolean)
+  int binary = 0; // 1 to write edges with 16-bit weights instead of .gml text (Boolean)
+  int framed = 0; // 1 to write edges in compressed frames with an index (Boolean)
+  char *logBase = NULL; // base for log, checkpoint and stats file names (NULL to take from output name)
+  int numPerms = 0; // number of permutation replicates (0 to use real data)
+  unsigned long int seed = (unsigned long int)getpid(); // random seed for permutations
+  char *groupName = NULL; // file assigning individuals to groups
+  char *posName = NULL; // SNP info file with chromosomes and positions
+  int posCols = 0, posHeadRows = 0; // columns and header rows of SNP info file
+  long int window = 0; // window in base pairs (-1 for cross-chromosome pairs only)
+  int haveWindow = 0; // 1 if window or cross-chromosome pairs were asked for (Boolean)
+  int prefilter = 0; // 1 for candidates from min-hash signatures, 2 for estimates on a subsample
+  int subsample = 0; // individuals in subsample
+  float margin = SUBSAMPLE_MARGIN; // margin below threshold for subsample estimates
+  int auditRows = AUDIT_ROWS; // rows sampled to measure recall of candidate pairs
+
+  for (int i = numArgs; i < argc; i++) {
+    if (strcmp(argv[i], "--resume") == 0)
+      resume = 1;
+
+    else if (strcmp(argv[i], "--exact") == 0)
+      exact = 1;
+
+    else if ((strcmp(argv[i], "--checkpoint") == 0) && (i+1 < argc))
+      ckptInterval = atoi(argv[++i]);
+
+    else if ((strcmp(argv[i], "--progress") == 0) && (i+1 < argc))
+      progInterval = atoi(argv[++i]);
+
+    else if ((strcmp(argv[i], "--components") == 0) && (i+1 < argc))
+      compName = argv[++i];
+
+    else if (strcmp(argv[i], "--no-gml") == 0)
+      gml = 0;
+
+    else if (strcmp(argv[i], "--binary") == 0)
+      binary = 1;
+
+    else if (strcmp(argv[i], "--framed") == 0)
+      framed = 1;
+
+    else if ((strcmp(argv[i], "--log") == 0) && (i+1 < argc))
+      logBase = argv[++i];
+
+    else if ((strcmp(argv[i], "--permutations") == 0) && (i+1 < argc))
+      numPerms = atoi(argv[++i]);
+
+    else if ((strcmp(argv[i], "--seed") == 0) && (i+1 < argc))
+      seed = strtoul(argv[++i], NULL, 10);
+
+    else if ((strcmp(argv[i], "--groups") == 0) && (i+1 < argc))
+      groupName = argv[++i];
+
+    else if ((strcmp(argv[i], "--positions") == 0) && (i+3 < argc)) {
+      posName = argv[++i];
+      posCols = atoi(argv[++i]);
+      posHeadRows = atoi(argv[++i]);
+    }
+
+    else if ((strcmp(argv[i], "--window") == 0) && (i+1 < argc)) {
+      window = atol(argv[++i]);
+      haveWindow = 1;
+      if (window < 0)
+	fatal("Window must not be negative");
+    }
+
+    else if (strcmp(argv[i], "--cross-chromosome") == 0) {
+      window = -1;
+      haveWindow = 1;
+    }
+
+    else if (strcmp(argv[i], "--minhash") == 0)
+      prefilter = (prefilter == 0) ? 1 : -1;
+
+    else if ((strcmp(argv[i], "--subsample") == 0) && (i+1 < argc)) {
+      prefilter = (prefilter == 0) ? 2 : -1;
+      subsample = atoi(argv[++i]);
+      if (subsample < 1)
+	fatal("Subsample must have at least one individual");
+    }
+
+    else if ((strcmp(argv[i], "--margin") == 0) && (i+1 < argc)) {
+      margin = atof(argv[++i]);
+      if (margin < 0)
+	fatal("Margin must not be negative");
+    }
+
+    else if ((strcmp(argv[i], "--audit") == 0) && (i+1 < argc))
+      auditRows = atoi(argv[++i]);
+
+    else {
+      cout << argv[i] << endl;
+      fatal("Unrecognized optional argument");
+    }
+  }
+
+  if (!gml && (compName == NULL))
+    fatal("Nothing would be written: --no-gml requires --components");
+
+  int toStdout = (strcmp(argv[2], "-") == 0); // 1 if edges are written to standard output (Boolean)
+
+  if (toStdout && (logBase == NULL))
+    fatal("Output '-' (standard output) requires --log base for the other file names");
+
+  // edges written to standard output or a pipe can't be taken back, so
+  // there is no checkpoint to resume from
+  struct stat outStat; // type of an existing output file
+  int streamed = gml && (toStdout || ((stat(argv[2], &outStat) == 0) && !S_ISREG(outStat.st_mode)));
+
+  if (streamed && resume)
+    fatal("Can't resume when edges are written to standard output or a pipe");
+
+  if (streamed)
+    ckptInterval = 0; // no checkpoints
+
+  if (toStdout) // keep screen output out of the edges
+    cout.rdbuf(cerr.rdbuf());
+
+  if (binary && (!gml || (numPerms > 0) || (groupName != NULL)))
+    fatal("--binary can't be combined with --no-gml, --permutations or --groups");
+
+  if (framed && (!gml || (numPerms > 0) || (groupName != NULL)))
+    fatal("--framed can't be combined with --no-gml, --permutations or --groups");
+
+  if ((numPerms < 0) || ((numPerms > 0) && (resume || exact || (compName != NULL) || !gml)))
+    fatal("--permutations can't be combined with --resume, --exact, --components or --no-gml");
+
+  if ((groupName != NULL) && (resume || exact || (compName != NULL) || !gml || (numPerms > 0)))
+    fatal("--groups can't be combined with --resume, --exact, --components, --no-gml or --permutations");
+
+  int windowed = (posName != NULL); // 1 if pairs are chosen by position (Boolean)
+
+  if (windowed != haveWindow)
+    fatal("--positions must be given with either --window bp or --cross-chromosome");
+
+  if (windowed && ((numPerms > 0) || (groupName != NULL)))
+    fatal("--positions can't be combined with --permutations or --groups");
+
+  if (prefilter < 0)
+    fatal("Only one of --minhash and --subsample can be given");
+
+  if (prefilter && (windowed || (numPerms > 0) || (groupName != NULL)))
+    fatal("--minhash and --subsample can't be combined with --positions, --permutations or --groups");
 
   timer t;
   t.start("Timer started.");
@@ -42,6 +216,13 @@ int main(int argc, char ** argv)
   const char logSuffix[] = ".bloc.log"; // suffix for logfile name
 
   // determine name for logfile
+  if (logBase != NULL) {
+    if (strlen(logBase) > 99)
+      fatal("Name given with --log is too long");
+    strcpy(base, logBase);
+  }
+
+  else {
     for (int i = 0; i < 100; i++) {
       base[i] = argv[2][i]; // copy output file name
       if (base[i] == '\0') {
@@ -52,16 +233,29 @@ int main(int argc, char ** argv)
 	break;
       }
     }
-  
-    sprintf(logfileName, "%s%s", base, logSuffix); // string together file name
+  }
+
+  sprintf(logfileName, "%s%s", base, logSuffix); // string together file name
+
+  char ckptName[200]; // hold name of checkpoint file
+  sprintf(ckptName, "%s.ckpt", base);
+
+  char statsName[200]; // hold name of stats file written at end of run
+  sprintf(statsName, "%s.stats", base);
+
+  char permName[200]; // hold name of file for permutation replicates
+  sprintf(permName, "%s.perm", base);
 
   if(LOG_FILE) 
     cout << "Screen output will be recorded in '" << logfileName <<"'.\n" << endl;
 
-  if ((logfile = fopen(logfileName, "w")) == NULL)
+  if ((logfile = fopen(logfileName, resume ? "a" : "w")) == NULL)
       fatal("Log file could not be opened.\n");
 
   if (LOG_FILE) {
+    if (resume)
+      fprintf(logfile, "\n\n*** Resuming from checkpoint in '%s'. ***\n", ckptName);
+
     fprintf(logfile, "\nCommand line arguments: \n\t");
     for (int i = 0; i < argc; i++)
       fprintf(logfile, "%s ", argv[i]);
@@ -70,6 +264,17 @@ int main(int argc, char ** argv)
 
   float thresh = atof(argv[3]);
 
+  long int threshNum, threshDen; // threshold as a fraction for exact evaluation
+  if (exact && !parseThreshold(argv[3], &threshNum, &threshDen))
+    fatal("Threshold must be a plain decimal value (such as 0.7) with --exact");
+
+  if (exact) {
+    cout << "CCC values will be evaluated exactly with integer arithmetic." << endl;
+
+    if(LOG_FILE)
+      fprintf(logfile, "CCC values will be evaluated exactly with integer arithmetic.\n");
+  }
+
   // changed default threshold, so this is just a reminder
   if ((thresh < 0.7-TOL) || (thresh > 0.7+TOL))
     warning("Default threshold value is 0.7.");
@@ -132,14 +337,14 @@ int main(int argc, char ** argv)
   int end2 = numSnps;
 
   // change values if different values given on command line
-  if(argc == 12) { 
+  if(numArgs == 12) { 
 	start1 = atoi(argv[8]);
 	end1 = atoi(argv[9]);
 	start2 = atoi(argv[10]);
 	end2 = atoi(argv[11]);
   }
 
-  if (argc == 12) {
+  if (numArgs == 12) {
     cout << "First SNP will range between " << start1 << " and " << end1 << endl;
     cout << "Second SNP will range between " << start2 << " and " << end2 << endl;
 
@@ -227,7 +432,7 @@ int main(int argc, char ** argv)
 	cout << numSnps1 << " SNPs in first set, " << numSnps2 << " SNPs in second set." << endl;
 
   int printFreq = 0; // flag to print frequencies out to 'temp.freq'
-  if (PRINTFREQ && (argc == 8))
+  if (PRINTFREQ && (numArgs == 8))
     printFreq = 1; // set flag to print frequencies only if full data set being computed
 
   // allocate data memory
@@ -240,58 +445,41 @@ int main(int argc, char ** argv)
   if (((data1 = new char* [numSnps1]) == NULL) || ((data2 = new char* [numSnps2]) == NULL))
     fatal("Memory not allocated");
 
-  for (int i = 0; i < numSnps1; i++)
-    if ((data1[i] = new char[numInd]) == NULL)
-      fatal("Memory not allocated");
-
-  for (int i = 0; i < numSnps2; i++)
-    if ((data2[i] = new char[numInd]) == NULL)
-      fatal("Memory not allocated");
-
-  // initialize values to '4' as valid values are 0, 1, 2, or 3
-  for (int i = 0; i < numSnps1; i++)
-    for (int j = 0; j < numInd; j++)
-      data1[i][j] = '4';
-
-  for (int i = 0; i < numSnps2; i++)
-    for (int j = 0; j < numInd; j++)
-      data2[i][j] = '4';
+  // hold marginal counts for each SNP and lists for rare-variant SNPs;
+  // dense rows are only allocated for the other SNPs, as the input is read
+  SparseSnp *snp1; // first set of SNPs
+  SparseSnp *snp2; // second set of SNPs
 
-  // allocate memory for storing frequency information
-  double **freq1; // hold frequency values for alleles for first SNP set
-  double **freq2; // hold frequency values for alleles for second SNP set  
-
-  if ((freq1 = new double*[numSnps1]) == NULL) 
+  if (((snp1 = new SparseSnp[numSnps1]) == NULL) || ((snp2 = new SparseSnp[numSnps2]) == NULL))
     fatal("memory not allocated");
 
-  for (int i = 0; i < numSnps1; i++)
-    if ((freq1[i] = new double[2]) == NULL)
-      fatal("memory not allocated");  
+  float maxFrac = SPARSE ? SPARSE_FRAC : -1.0; // negative to keep all rows dense
+  if (groupName != NULL)
+    maxFrac = -1.0; // groups are tallied from dense rows
 
-  if ((freq2 = new double*[numSnps2]) == NULL) 
-    fatal("memory not allocated");
+  // allocate memory for storing frequency information
+  FreqVec freq1; // hold frequency values for alleles for first SNP set
+  FreqVec freq2; // hold frequency values for alleles for second SNP set  
 
-  for (int i = 0; i < numSnps2; i++)
-    if ((freq2[i] = new double[2]) == NULL)
-      fatal("memory not allocated");
+  for (int j = 0; j < 2; j++) {
+    freq1.f[j] = (double*)alignedAlloc(numSnps1 * sizeof(double));
+    freq2.f[j] = (double*)alignedAlloc(numSnps2 * sizeof(double));
+  }
 
   // initialize frequency values to zero
   for (int i = 0; i < numSnps1; i++)
     for (int j = 0; j < 2; j++)
-      freq1[i][j] = 0;
+      freq1.f[j][i] = 0;
 
   for (int i = 0; i < numSnps2; i++)
     for (int j = 0; j < 2; j++)
-      freq2[i][j] = 0;
+      freq2.f[j][i] = 0;
 
   // allocate memory for holding alleles for each SNP
-  char **allele;  
+  char (*allele)[2];  
 
-  if ((allele = new char*[numSnps]) == NULL)
+  if ((allele = new char[numSnps][2]) == NULL)
     fatal("memory not allocated");
-  for (int i = 0; i < numSnps; i++)
-    if ((allele[i] = new char[2]) == NULL)
-      fatal("memory not allocated");
 
   // initialize alleles to zero
   for (int i = 0; i < numSnps; i++)
@@ -303,12 +491,223 @@ int main(int argc, char ** argv)
 
   // format function will assemble data in the matrices and 
   // writes out the number of missing values
-  format(argv[1], data1, data2, allele, freq1, freq2, numSnps, numInd, start1, end1, start2, end2, logfileName, numheadrows, numheadcols, printFreq); 
+  format(argv[1], data1, data2, snp1, snp2, maxFrac, allele, &freq1, &freq2, numSnps, numInd, start1, end1, start2, end2, logfileName, numheadrows, numheadcols, printFreq); 
 
   //reopen logfile
   if ((logfile = fopen(logfileName, "a")) == NULL)
       fatal("Log file could not be opened.\n");
 
+  int numSparse1 = 0; // number of SNPs stored as lists in first set
+  int numSparse2 = 0; // number of SNPs stored as lists in second set
+
+  for (int i = 0; i < numSnps1; i++)
+    numSparse1 += snp1[i].sparse;
+
+  for (int i = 0; i < numSnps2; i++)
+    numSparse2 += snp2[i].sparse;
+
+  // integer frequency factors for exact evaluation
+  ExactFreq *ef1 = NULL; // first set of SNPs
+  ExactFreq *ef2 = NULL; // second set of SNPs
+
+  if (exact) {
+    if (((ef1 = new ExactFreq[numSnps1]) == NULL) || ((ef2 = new ExactFreq[numSnps2]) == NULL))
+      fatal("memory not allocated");
+
+    for (int i = 0; i < numSnps1; i++)
+      exactFreq(&snp1[i], &ef1[i]);
+    for (int i = 0; i < numSnps2; i++)
+      exactFreq(&snp2[i], &ef2[i]);
+  }
+
+  if (SPARSE) {
+    cout << numSparse1 << " and " << numSparse2 << " rare-variant SNPs stored as lists in first and second SNP sets, respectively." << endl;
+
+    if(LOG_FILE)
+      fprintf(logfile, "%d and %d rare-variant SNPs stored as lists in first and second SNP sets, respectively.\n", numSparse1, numSparse2);
+  }
+
+  if (numPerms > 0) { // null distribution only, real data isn't output
+    cout << "\nComputing CCC values for " << numPerms << " permutation replicates with seed " << seed << "..." << endl;
+
+    if(LOG_FILE)
+      fprintf(logfile, "\nComputing CCC values for %d permutation replicates with seed %lu...\n", numPerms, seed);
+
+    SnpSet set1 = {numSnps1, start1, data1, snp1, &freq1}; // real data
+    SnpSet set2 = {numSnps2, start2, data2, snp2, &freq2};
+    PermResult *result; // maximum and number of edges for each replicate
+
+    if ((result = new PermResult[numPerms]) == NULL)
+      fatal("memory not allocated");
+
+    runPermutations(&set1, &set2, numInd, thresh / 4.5, maxFrac, numPerms, seed, result);
+    reportPermutations(permName, result, numPerms, thresh, seed, logfile);
+    delete [] result;
+
+    t.stop("\nTimer stopped.");
+    cout << t << " seconds.\n" << endl;
+
+    if(LOG_FILE)
+      fprintf(logfile, "\nTimer stopped.\n%f seconds.\n", t.timeVal());
+
+    fclose(logfile);
+    return 1;
+  }
+
+  if (groupName != NULL) { // one network for each group of individuals
+    GroupMap map; // group of each individual
+    readGroups(groupName, numInd, &map);
+
+    cout << "\nComputing CCC values for " << map.numGroups << " groups of individuals..." << endl;
+
+    if(LOG_FILE)
+      fprintf(logfile, "\nComputing CCC values for %d groups of individuals...\n", map.numGroups);
+
+    FreqVec *gfreq1, *gfreq2; // frequency factors of each group
+    FILE **goutput; // output file of each group
+    long int *gEdges; // number of edges printed for each group
+    float *gMax; // maximum value found for each group
+    char groupFile[300]; // name of output file of a group
+
+    if (((gfreq1 = new FreqVec[map.numGroups]) == NULL) || ((gfreq2 = new FreqVec[map.numGroups]) == NULL))
+      fatal("memory not allocated");
+    if (((goutput = new FILE*[map.numGroups]) == NULL) || ((gEdges = new long int[map.numGroups]) == NULL) || ((gMax = new float[map.numGroups]) == NULL))
+      fatal("memory not allocated");
+
+    groupFreqs(data1, numSnps1, numInd, &map, gfreq1);
+    groupFreqs(data2, numSnps2, numInd, &map, gfreq2);
+
+    int graphNodes = TWONODE ? numNodes : numSnps; // nodes in each output graph
+
+    for (int g = 0; g < map.numGroups; g++) {
+      sprintf(groupFile, "%s.%s.gml", base, map.label[g]);
+      if ((goutput[g] = fopen(groupFile, "w")) == NULL)
+	fatal("Group output file could not be opened.\n");
+
+      fprintf(goutput[g], "Graph with %d nodes. \ngraph\n[\n", graphNodes);
+      for (int j = 1; j <= graphNodes; j++)
+	fprintf(goutput[g], "\tnode \n\t[\n\tid %d \n\t]\n", j);
+    }
+
+    long int totalPairs = 0; // pairs in entire run
+    long int *rowPairs; // number of pairs for each row of first set
+
+    if ((rowPairs = new long int[numSnps1]) == NULL)
+      fatal("memory not allocated");
+
+    for (int i = 0; i < numSnps1; i++) {
+      int firstJ = start1 + i - start2 + 1; // first SNP of second set in upper diagonal
+      if (firstJ < 0)
+	firstJ = 0;
+      rowPairs[i] = (firstJ < numSnps2) ? numSnps2 - firstJ : 0;
+      totalPairs += rowPairs[i];
+    }
+
+    Progress prog; // counters for progress reports
+    startProgress(&prog, progInterval, totalPairs, 0, 0);
+
+    sweepGroups(data1, numSnps1, start1, gfreq1, data2, numSnps2, start2, gfreq2, numInd, numSnps, &map, thresh / 4.5, goutput, gEdges, gMax, rowPairs, &prog, logfile);
+
+    cout << endl;
+    for (int g = 0; g < map.numGroups; g++) {
+      fprintf(goutput[g], "]\n"); // print closing bracket
+      fclose(goutput[g]);
+
+      sprintf(groupFile, "%s.%s.gml", base, map.label[g]);
+      cout << "Group '" << map.label[g] << "': " << map.size[g] << " individuals, " << gEdges[g] << " Custom correlations with values >= " << thresh << ", maximum " << gMax[g] << ", written to '" << groupFile << "'." << endl;
+
+      if(LOG_FILE)
+	fprintf(logfile, "Group '%s': %d individuals, %ld Custom correlations with values >= %f, maximum %f, written to '%s'.\n", map.label[g], map.size[g], gEdges[g], thresh, gMax[g], groupFile);
+
+      for (int j = 0; j < 2; j++) {
+	free(gfreq1[g].f[j]);
+	free(gfreq2[g].f[j]);
+      }
+    }
+
+    delete [] gfreq1;
+    delete [] gfreq2;
+    delete [] goutput;
+    delete [] gEdges;
+    delete [] gMax;
+    delete [] rowPairs;
+    delete [] map.group;
+
+    t.stop("\nTimer stopped.");
+    cout << t << " seconds.\n" << endl;
+
+    if(LOG_FILE)
+      fprintf(logfile, "\nTimer stopped.\n%f seconds.\n", t.timeVal());
+
+    fclose(logfile);
+    return 1;
+  }
+
+  SnpIndex index; // SNP positions, sorted for finding windows
+  int *pairList = NULL; // SNPs of second set paired with current SNP
+
+  if (windowed) {
+    readPositions(posName, posCols, posHeadRows, numSnps, &index);
+    buildIndex(&index, start2, numSnps2, window);
+
+    if ((pairList = new int[numSnps2]) == NULL)
+      fatal("memory not allocated");
+
+    if (window < 0) {
+      cout << "Only pairs of SNPs on different chromosomes will be evaluated." << endl;
+
+      if(LOG_FILE)
+	fprintf(logfile, "Only pairs of SNPs on different chromosomes will be evaluated.\n");
+    }
+
+    else {
+      cout << "Only pairs of SNPs within " << window << " base pairs on the same chromosome will be evaluated." << endl;
+
+      if(LOG_FILE)
+	fprintf(logfile, "Only pairs of SNPs within %ld base pairs on the same chromosome will be evaluated.\n", window);
+    }
+  }
+
+  MinHash mh; // signatures and buckets for finding candidate pairs
+  Subsample sub; // packed genotypes of subsample for estimating values
+  int (*candidates)(const void*, int, int, int*, char*) = NULL; // lists candidate pairs
+  const void *filter = NULL; // structure passed to candidates()
+  char *pairMark = NULL; // work space for finding candidate pairs
+
+  if (prefilter) {
+    if (((pairList = new int[numSnps2]) == NULL) || ((pairMark = new char[numSnps2]) == NULL))
+      fatal("memory not allocated");
+    memset(pairMark, 0, numSnps2);
+
+    SnpSet set1 = {numSnps1, start1, data1, snp1, &freq1};
+    SnpSet set2 = {numSnps2, start2, data2, snp2, &freq2};
+
+    if (prefilter == 1) {
+      buildMinHash(&mh, &set1, &set2, numInd, thresh);
+      candidates = minHashPairs;
+      filter = &mh;
+
+      cout << "Only candidate pairs from min-hash signatures with " << MINHASH_BANDS << " bands of " << MINHASH_ROWS << " values will be evaluated." << endl;
+
+      if(LOG_FILE)
+	fprintf(logfile, "Only candidate pairs from min-hash signatures with %d bands of %d values will be evaluated.\n", MINHASH_BANDS, MINHASH_ROWS);
+    }
+
+    else {
+      buildSubsample(&sub, &set1, &set2, numInd, subsample, thresh, margin);
+      candidates = subsamplePairs;
+      filter = &sub;
+
+      cout << "Only pairs with values of at least " << thresh - margin << " on a subsample of " << sub.numInd << " individuals will be evaluated." << endl;
+
+      if(LOG_FILE)
+	fprintf(logfile, "Only pairs with values of at least %f on a subsample of %d individuals will be evaluated.\n", thresh - margin, sub.numInd);
+    }
+
+    if (auditRows > 0)
+      auditRecall(candidates, filter, &set1, &set2, numInd, thresh / 4.5, auditRows, logfile);
+  }
+
   cout << "\nComputing CCC values..." << endl;
 
   if(LOG_FILE)
@@ -318,53 +717,214 @@ int main(int argc, char ** argv)
   FILE *output;
   FILE *edgefile; // use for edge IDs if PRINT_EDGE_IDS is set to 1
 
-  if ((output = fopen(argv[2], "w")) == NULL)
-      fatal("Output file could not be opened.\n");
+  // record parameters of this run for checkpoints
+  Checkpoint ckpt;
+  sprintf(ckpt.input, "%.199s", argv[1]);
+  ckpt.thresh = thresh;
+  ckpt.numInd = numInd;
+  ckpt.numSnps = numSnps;
+  ckpt.start1 = start1;
+  ckpt.end1 = end1;
+  ckpt.start2 = start2;
+  ckpt.end2 = end2;
+  ckpt.exact = exact;
+  ckpt.components = (compName != NULL);
+  ckpt.gml = gml;
+  ckpt.binary = binary;
+  ckpt.framed = framed;
+  ckpt.window = windowed ? window : -2;
+  ckpt.prefilter = prefilter;
+  ckpt.subsample = subsample;
+  ckpt.margin = margin;
+
+  float maxBloc = 0.0; // initialize for finding max and min values
+  float minBloc = 1.0; 
+  long int numEdges = 0; // tally number of edges printed out
+  float minNoMissing = (float)numInd * NOMISS; // minimum of no missing relationships
+  int startRow = 0; // first row of first SNP set to compute
+
+  // union-find structure for components, keyed on node ids of output graph
+  UnionFind uf;
+  UnionFind *ufPtr = NULL; // NULL unless components are found
+  char ufName[220]; // file holding union-find state of latest checkpoint
+  ufName[0] = '\0';
+
+  output = NULL; // stays NULL when edges aren't written
+  long int outBytes = 0; // bytes of edges written, unless framed (frames count their own)
+  FrameWriter frames; // compressed frames of edges if framed
+  if (compName != NULL) {
+    allocUnionFind(&uf, TWONODE ? numNodes : numSnps);
+    ufPtr = &uf;
+  }
+
+  if (resume) { // continue from last checkpoint
+    Checkpoint last; // state saved by interrupted run
+
+    if (!readCheckpoint(ckptName, &last))
+      fatal("No checkpoint file found to resume from");
 
-  if (TWONODE) { // 2 nodes for each SNP
-    fprintf(output, "Graph with %d nodes. \ngraph\n[\n", numNodes);
-    for (int j = 1; j <= numNodes; j++)
-      fprintf(output, "\tnode \n\t[\n\tid %d \n\t]\n", j);
+    if ((strcmp(last.input, ckpt.input) != 0) || (last.thresh != ckpt.thresh) || (last.numInd != numInd) || (last.numSnps != numSnps))
+      fatal("Checkpoint was written for a run with different arguments");
+
+    if ((last.start1 != start1) || (last.end1 != end1) || (last.start2 != start2) || (last.end2 != end2))
+      fatal("Checkpoint was written for a run with different SNP ranges");
+
+    if (last.exact != exact)
+      fatal("Checkpoint was written for a run with a different evaluation mode");
+
+    if ((last.window != ckpt.window) || (last.prefilter != prefilter) || (last.subsample != subsample) || (last.margin != margin))
+      fatal("Checkpoint was written for a run with a different choice of pairs");
+
+    if ((last.components != ckpt.components) || (last.gml != gml) || (last.binary != binary) || (last.framed != framed))
+      fatal("Checkpoint was written for a run with different outputs");
+
+    if (PRINT_EDGE_IDS)
+      fatal("Can't resume when PRINT_EDGE_IDS is set to 1 in bloc.h");
+
+    if (gml) {
+      if ((output = fopen(argv[2], "r+")) == NULL)
+	fatal("Output file could not be opened to resume.\n");
+
+      // discard edges written after the checkpoint was taken
+      fflush(output);
+      if (ftruncate(fileno(output), last.offset) != 0)
+	fatal("Output file could not be truncated to checkpoint.\n");
+      if (fseek(output, last.offset, SEEK_SET) != 0)
+	fatal("Output file could not be positioned at checkpoint.\n");
+
+      if (framed && !resumeFrames(&frames, output, last.offset))
+	fatal("Frames of output file could not be read back to checkpoint.\n");
+      outBytes = last.offset;
+    }
+
+    if (compName != NULL) { // components found before checkpoint
+      sprintf(ufName, "%s.uf%d", ckptName, last.rowsDone);
+      loadUnionFind(ufName, &uf, last.rowsDone);
+    }
+
+    startRow = last.rowsDone;
+    numEdges = last.numEdges;
+    maxBloc = last.maxBloc;
+    minBloc = last.minBloc;
+
+    cout << "Resuming at SNP " << start1+startRow+1 << " of first set with " << numEdges << " edges already printed." << endl;
+
+    if(LOG_FILE)
+      fprintf(logfile, "Resuming at SNP %d of first set with %ld edges already printed.\n", start1+startRow+1, numEdges);
   }
+
+  else if (gml) {
+    if (toStdout)
+      output = stdout;
+    else if ((output = fopen(argv[2], (binary || framed) ? "wb" : "w")) == NULL)
+      fatal("Output file could not be opened.\n");
+
+    if (framed) { // header holds number of nodes and type of frames
+      if (!startFrames(&frames, output, TWONODE ? numNodes : numSnps, binary))
+	fatal("Output file could not be written.\n");
+    }
+
+    else if (binary) { // header holds number of nodes
+      if (!writeBinaryHead(output, TWONODE ? numNodes : numSnps))
+	fatal("Output file could not be written.\n");
+      outBytes = BINARY_HEAD_BYTES;
+    }
+
+    else if (TWONODE) { // 2 nodes for each SNP
+      outBytes += fprintf(output, "Graph with %d nodes. \ngraph\n[\n", numNodes);
+      for (int j = 1; j <= numNodes; j++)
+	outBytes += fprintf(output, "\tnode \n\t[\n\tid %d \n\t]\n", j);
+    }
   
-  else {
-    fprintf(output, "Graph with %d nodes. \ngraph\n[\n", numSnps);
-    for (int j = 1; j <= numSnps; j++)
-      fprintf(output, "\tnode \n\t[\n\tid %d \n\t]\n", j);
+    else {
+      outBytes += fprintf(output, "Graph with %d nodes. \ngraph\n[\n", numSnps);
+      for (int j = 1; j <= numSnps; j++)
+	outBytes += fprintf(output, "\tnode \n\t[\n\tid %d \n\t]\n", j);
+    }
   }
   
-  // compute correlations and output edges
+  if (streamed) {
+    cout << "Edges are streamed, so no checkpoints will be saved." << endl;
+    if(LOG_FILE)
+      fprintf(logfile, "Edges are streamed to '%s', so no checkpoints will be saved.\n", argv[2]);
+  }
 
-  float tally[4][4]; // tally number of each of 16 possible combinations
-  float maxBloc = 0.0; // initialize for finding max and min values
-  float minBloc = 1.0; 
-  long int numEdges = 0; // tally number of edges printed out
-  float minNoMissing = (float)numInd * NOMISS; // minimum of no missing relationships
+  // compute correlations and output edges
 
   // adjust threshold to equal unscaled and unshifted value
   thresh = thresh / 4.5; // divide by 4.5 to get R_ij * ff_i * ff_j value
 
+  time_t lastCkpt = time(0); // time of last checkpoint
+
+  // count pairs in upper diagonal for progress reports
+  long int totalPairs = 0; // pairs in entire run
+  long int pairsDone = 0; // pairs in completed rows
+  long int *rowPairs; // number of pairs for each row of first set
+
+  if ((rowPairs = new long int[numSnps1]) == NULL)
+    fatal("memory not allocated");
+
+  for (int i = 0; i < numSnps1; i++) {
+    int firstJ = start1 + i - start2 + 1; // first SNP of second set in upper diagonal
+    if (firstJ < 0)
+      firstJ = 0;
+    rowPairs[i] = (firstJ < numSnps2) ? numSnps2 - firstJ : 0;
+    if (windowed)
+      rowPairs[i] = windowPairs(&index, start1+i, firstJ, pairList);
+    if (prefilter == 1) // subsample estimates are only found in main loop
+      rowPairs[i] = minHashPairs(&mh, i, firstJ, pairList, pairMark);
+    totalPairs += rowPairs[i];
+    if (i < startRow)
+      pairsDone += rowPairs[i];
+  }
+
+  Progress prog; // counters for progress reports
+  startProgress(&prog, progInterval, totalPairs, pairsDone, numEdges);
+
   // tally pairwise correlations
-  for (int i = 0; i < numSnps1; i++) // start with each SNP in first set
-    for (int j = 0; j < numSnps2; j++)  // pair with each SNP in second set
+  PairTile tile; // arrays for a tile of pairs that share their first SNP
+  allocTile(&tile);
+
+  for (int i = startRow; i < numSnps1; i++) { // start with each SNP in first set
+
+    // only compute upper diagonal of matrix
+    int firstJ = start1 + i - start2 + 1; // first SNP of second set paired with SNP i
+    if (firstJ < 0)
+      firstJ = 0;
+
+    int numPairs = numSnps2 - firstJ; // number of SNPs of second set paired with SNP i
+    int *pairJ = NULL; // list of these SNPs, NULL when they are consecutive
 
-      if (start1+i < start2+j) { // only compute upper diagonal of matrix
+    if (windowed) { // only SNPs in window
+      numPairs = windowPairs(&index, start1+i, firstJ, pairList);
+      pairJ = pairList;
+    }
+
+    if (prefilter) { // only candidate pairs
+      numPairs = candidates(filter, i, firstJ, pairList, pairMark);
+      pairJ = pairList;
+    }
 
-      // initialize values
-      for (int row = 0; row < 4; row++)
-	for (int col = 0; col < 4; col++)
-	  tally[row][col] = 0;
+    // pair with SNPs in second set, PAIR_BLOCK at a time
+    for (int tileFirst = 0; tileFirst < numPairs; tileFirst += PAIR_BLOCK) {
+      int tileSize = numPairs - tileFirst; // number of pairs in this tile
+      if (tileSize > PAIR_BLOCK)
+	tileSize = PAIR_BLOCK;
+      int tileStart = firstJ + tileFirst; // first SNP of tile when consecutive
+
+      for (int b = 0; b < tileSize; b++) { // tally each pair in tile
+      int j = (pairJ == NULL) ? tileStart + b : pairJ[tileFirst + b]; // index of SNP in second set
+      int count[4][4]; // number of individuals with each relationship
 
       // add up number of individuals with each relationship      
-      for (int k = 0; k < numInd; k++)
-	tally[data1[i][k]][data2[j][k]]++; 
+      pairTally(count, &snp1[i], data1[i], &snp2[j], data2[j], numInd);
 
       // count how many individuals have no missing data
       int noMissing = 0;
       
       for (int row = 0; row < 3; row++) 
 	for (int col = 0; col < 3; col++)
-	  noMissing += (int)tally[row][col];
+	  noMissing += count[row][col];
       
       //cout << noMissing << " relationships" << endl;
       
@@ -378,67 +938,77 @@ int main(int argc, char ** argv)
 	  fprintf(logfile, "SNPs %d and %d have %d relationships without missing data.\nWarning: Correlation is based on too few relationships.\n\n", start1+i+1, start2+j+1, noMissing);
       }
 
-      // adjust proportionate contributions of each relationship
-      tally[1][1] /= 4.0; // both heterozygous
-      tally[0][1] /= 2.0; // one heterozygous, the other homozygous
-      tally[1][0] /= 2.0; // one heterozygous, the other homozygous
-      tally[1][2] /= 2.0; // one heterozygous, the other homozygous
-      tally[2][1] /= 2.0; // one heterozygous, the other homozygous
+      if (exact) { // compare cross-multiplied integers
+	// endpoints of the ll, lh, hl and hh edges
+	int source[4] = {start1+i+1, start1+i+1, start1+i+numSnps+1, start1+i+numSnps+1};
+	int target[4] = {start2+j+1, start2+j+numSnps+1, start2+j+1, start2+j+numSnps+1};
 
-      // compute four relationship values
-      // both alleles are lowest alphabetically
-      float ll = tally[0][0] + tally[0][1] + tally[1][0] + tally[1][1];
+	uint128 val[4]; // numerators of ll, lh, hl and hh values
+	uint128 den; // common denominator of the four values
 
-      // first allele lowest, second highest
-      float lh = tally[0][1] + tally[0][2] + tally[1][1] + tally[1][2];
+	if (!exactValues(count, &ef1[i], &ef2[j], val, &den))
+	  continue; // no individuals without missing data
 
-      // first allele highest, second lowest
-      float hl = tally[1][0] + tally[1][1] + tally[2][0] + tally[2][1];
+	int maxRel = 0; // find relationship with maximum value
+	for (int r = 1; r < 4; r++)
+	  if (val[r] > val[maxRel])
+	    maxRel = r;
 
-      // both alleles are highest alphabetically
-      float hh = tally[1][1] + tally[1][2] + tally[2][1] + tally[2][2];
+	// value = 9 * val / (8 * den) is at least threshNum / threshDen when
+	// 9 * val * threshDen >= 8 * den * threshNum
+	uint128 cut = 8 * den * (uint128)threshNum;
 
-      if (0) 
-	cout << start1+i+1 << ", " << start2+j+1 << ": " << "ll = " << ll << ", lh = " << lh << ", hl = " << hl << ", hh = " << hh << endl;
+	// update maximum and minimum values found for data set (unscaled)
+	float max = (float)((long double)val[maxRel] / (4.0L * (long double)den));
+	if (max > maxBloc)
+	  maxBloc = max;
 
-      // find average by dividing by number of individuals
-      ll /= (float)noMissing;
-      lh /= (float)noMissing;
-      hl /= (float)noMissing;
-      hh /= (float)noMissing;
+	if (max < minBloc)
+	  minBloc = max;
 
-      if (0) { // temporary check to see if values add to one
-	float tempSum = ll+lh+hl+hh;
-	if ((tempSum > 1.0+TOL) || (tempSum < 1.0-TOL)) {
-	  cout << tempSum << endl;
-	  fatal("Values do not add to one");
+	if (!TWONODE) { // just one possible edge to print out
+	  if (9 * val[maxRel] * (uint128)threshDen >= cut)
+	    printEdge(output, logfile, source[0], target[0], (float)(9.0L * (long double)val[maxRel] / (8.0L * (long double)den)), numNodes, &numEdges, &outBytes, ufPtr, binary, framed ? &frames : NULL);
 	}
-      }
 
-      if (0) 
-	cout << start1+i+1 << ", " << start2+j+1 << ": " << "ll = " << ll << ", lh = " << lh << ", hl = " << hl << ", hh = " << hh << endl;
+	else
+	  for (int r = 0; r < 4; r++)
+	    if (9 * val[r] * (uint128)threshDen >= cut)
+	      printEdge(output, logfile, source[r], target[r], (float)(9.0L * (long double)val[r] / (8.0L * (long double)den)), numNodes, &numEdges, &outBytes, ufPtr, binary, framed ? &frames : NULL);
+
+	// check that not too many edges are printed
+	if(numEdges > MAX_NUM_EDGES)
+	  fatal("Too many edges printed out. Check MAX_NUM_EDGES in header file.");
 
-      // multiply by frequency factors
-      if (FREQ) {
-	ll *= freq1[i][0] * freq2[j][0]; // multiply by two frequency factors
-	lh *= freq1[i][0] * freq2[j][1]; 
-	hl *= freq1[i][1] * freq2[j][0]; 
-	hh *= freq1[i][1] * freq2[j][1]; 
+	continue;
       }
 
-      if (VERBOSE) 
+      setTally(&tile, b, count); // store tallies of ll, lh, hl and hh
+      } // end of tally for each pair in tile
+
+      if (exact)
+	continue; // edges already printed
+
+      // find average by dividing by number of individuals and multiply 
+      // by frequency factors for every pair in tile at once
+      if (pairJ == NULL)
+	tileProducts(&tile, tileSize, &freq1, i, &freq2, tileStart);
+      else
+	tileProductsAt(&tile, tileSize, &freq1, i, &freq2, pairJ + tileFirst);
+      finaliseTile(&tile, tileSize);
+
+      for (int b = 0; b < tileSize; b++) { // check and print out each pair
+      int j = (pairJ == NULL) ? tileStart + b : pairJ[tileFirst + b]; // index of SNP in second set
+      float ll = tile.value[0][b];
+      float lh = tile.value[1][b];
+      float hl = tile.value[2][b];
+      float hh = tile.value[3][b];
+      float max = tile.max[b];
+
+      if (VERBOSE) {
 	cout << start1+i+1 << ", " << start2+j+1 << ": " << "ll = " << ll * 4.5 << ", lh = " << (lh * 4.5)  << ", hl = " << (hl * 4.5)  << ", hh = " << (hh * 4.5) << endl;
-
-      float max = ll; // find maximum value
-      if (lh > max)
-	max = lh;
-      if (hl > max)
-	max = hl;
-      if (hh > max)
-	max = hh;
-
-      if(VERBOSE)
 	cout << "Max = " << (max * 4.5) << endl;
+      }
 
       // update maximum and minimum values found for data set
       if (max > maxBloc)
@@ -468,116 +1038,77 @@ int main(int argc, char ** argv)
 	  if ((weight > 1.0 + TOL) || (weight < 0.0 - TOL))
 	    fatal("Invalid CCC value");
 
-	  fprintf(output, "\tedge\n\t[\n\tsource %d\n\ttarget %d\n\tweight %f\n\t]\n", start1+i+1, start2+j+1, weight);
-	  numEdges++;
-
-	  if(PRINT_EDGE_IDS) {
-	    if ((edgefile = fopen("edgeList.txt", "a")) == NULL)
-	      fatal("'edgeList.txt' file could not be opened.\n");
-	    fprintf(edgefile, "%d ", (start1+i+1)*numNodes + (start2+j+1));
-	    fclose(edgefile);
-	  }
+	  printEdge(output, logfile, start1+i+1, start2+j+1, weight, numNodes, &numEdges, &outBytes, ufPtr, binary, framed ? &frames : NULL);
 	}
 
       if (TWONODE) {
-	if(ll > thresh - TOL) { 
-
-	  float weight = (ll * 4.5);
-	  if ((weight > 1.0 + TOL) || (weight < 0.0 - TOL)) {
-	    cout << "\nWarning: CCC value is " << weight << endl;
-	    //fatal("Invalid CCC value");
-
-	    if(LOG_FILE)
-	      fprintf(logfile, "\nWarning: CCC value is %f\n", weight);
-	  }
-
-	  fprintf(output, "\tedge\n\t[\n\tsource %d\n\ttarget %d\n\tweight %f\n\t]\n", start1+i+1, start2+j+1, weight);
-	  numEdges++;	
-
-	  if(PRINT_EDGE_IDS) {
-	    if ((edgefile = fopen("edgeList.txt", "a")) == NULL)
-	      fatal("'edgeList.txt' file could not be opened.\n");
-	    fprintf(edgefile, "%d ", (start1+i+1)*numNodes + (start2+j+1));
-	    fclose(edgefile);
-	  }
-	}
-
-	if(lh > thresh - TOL) { 
-	  
-	  float weight = (lh * 4.5);
-	  if ((weight > 1.0 + TOL) || (weight < 0.0 - TOL)) {
-	    cout << "\nWarning: CCC value is " << weight << endl;
-	    //fatal("Invalid CCC value");
-	    
-	    
-	    if(LOG_FILE)
-	      fprintf(logfile, "\nWarning: CCC value is %f\n", weight);
-	  }
-
-	  fprintf(output, "\tedge\n\t[\n\tsource %d\n\ttarget %d\n\tweight %f\n\t]\n", start1+i+1, start2+j+numSnps+1, weight);
-	  numEdges++;
-
-	  if(PRINT_EDGE_IDS) {
-	    if ((edgefile = fopen("edgeList.txt", "a")) == NULL)
-	      fatal("'edgeList.txt' file could not be opened.\n");
-	    fprintf(edgefile, "%d ", (start1+i+1)*numNodes + (start2+j+numSnps+1));
-	    fclose(edgefile);
-	  }
-	}
-
-	if(hl > thresh - TOL) { 
-	  
-	  float weight = (hl * 4.5);
-	  if ((weight > 1.0 + TOL) || (weight < 0.0 - TOL)) {
-	    cout << "\nWarning: CCC value is " << weight << endl;
-	    //fatal("Invalid CCC value");
-
-	    if(LOG_FILE)
-	      fprintf(logfile, "\nWarning: CCC value is %f\n", weight);
-	  } 
-
-	  fprintf(output, "\tedge\n\t[\n\tsource %d\n\ttarget %d\n\tweight %f\n\t]\n", start1+i+numSnps+1, start2+j+1, weight);
-	  numEdges++;
-
-	  if(PRINT_EDGE_IDS) {
-	    if ((edgefile = fopen("edgeList.txt", "a")) == NULL)
-	      fatal("'edgeList.txt' file could not be opened.\n");
-	    fprintf(edgefile, "%d ", (start1+i+numSnps+1)*numNodes + (start2+j+1));
-	    fclose(edgefile);
-	  }
-	}
+	// endpoints of the ll, lh, hl and hh edges
+	int source[4] = {start1+i+1, start1+i+1, start1+i+numSnps+1, start1+i+numSnps+1};
+	int target[4] = {start2+j+1, start2+j+numSnps+1, start2+j+1, start2+j+numSnps+1};
 
-	if(hh > thresh - TOL) { 
-	  
-	  float weight = (hh * 4.5);
-	  if ((weight > 1.0 + TOL) || (weight < 0.0 - TOL)) {
-	    cout << "\nWarning: CCC value is " << weight << endl;
-	    //fatal("Invalid CCC value");
-	    
-	    if(LOG_FILE)
-	      fprintf(logfile, "\nWarning: CCC value is %f\n", weight);
-	  }
-
-	  fprintf(output, "\tedge\n\t[\n\tsource %d\n\ttarget %d\n\tweight %f\n\t]\n", start1+i+numSnps+1, start2+j+numSnps+1, weight);
-	  numEdges++;
-
-	  if(PRINT_EDGE_IDS) {
-	    if ((edgefile = fopen("edgeList.txt", "a")) == NULL)
-	      fatal("'edgeList.txt' file could not be opened.\n");
-	    fprintf(edgefile, "%d ", (start1+i+numSnps+1)*numNodes + (start2+j+numSnps+1));
-	    fclose(edgefile);
-	  }
-	}
+	for (int r = 0; r < 4; r++)
+	  if(tile.value[r][b] > thresh - TOL) 
+	    printEdge(output, logfile, source[r], target[r], (tile.value[r][b] * 4.5), numNodes, &numEdges, &outBytes, ufPtr, binary, framed ? &frames : NULL);
       }   
        
       // check that not too many edges are printed
       if(numEdges > MAX_NUM_EDGES)
 	fatal("Too many edges printed out. Check MAX_NUM_EDGES in header file.");
-    } // end of for (int j = i+1) loop
+      } // end of check and print for each pair in tile
+    } // end of for (int tileFirst) loop
+
+    pairsDone += rowPairs[i];
+    updateProgress(&prog, pairsDone, numEdges, framed ? frames.offset : outBytes, logfile);
+
+    // save state periodically so an interrupted run can be resumed
+    if ((ckptInterval > 0) && (time(0) - lastCkpt >= ckptInterval)) {
+      ckpt.rowsDone = i + 1;
+      ckpt.numEdges = numEdges;
+      ckpt.maxBloc = maxBloc;
+      ckpt.minBloc = minBloc;
+      ckpt.offset = 0;
+
+      if (gml && framed) { // end of last complete frame
+	if (!flushFrame(&frames) || !syncFile(output))
+	  fatal("Output file could not be written.\n");
+	ckpt.offset = frames.offset;
+      }
 
-  fprintf(output, "]\n"); // print closing bracket
+      else if (gml) { // edges reach the disk before the checkpoint points past them
+	if (!syncFile(output))
+	  fatal("Output file could not be written.\n");
+	ckpt.offset = outBytes;
+      }
 
-  fclose(output);
+      if (compName != NULL) { // save components first, named by rows done
+	char oldName[220]; // state saved at previous checkpoint
+	sprintf(oldName, "%s", ufName);
+	sprintf(ufName, "%s.uf%d", ckptName, ckpt.rowsDone);
+	saveUnionFind(ufName, &uf, ckpt.rowsDone);
+	writeCheckpoint(ckptName, &ckpt);
+	if ((oldName[0] != '\0') && (strcmp(oldName, ufName) != 0))
+	  remove(oldName);
+      }
+
+      else
+	writeCheckpoint(ckptName, &ckpt);
+      lastCkpt = time(0);
+    }
+  } // end of for (int i) loop
+
+  if (gml) {
+    if (framed && !finishFrames(&frames))
+      fatal("Output file could not be written.\n");
+    else if (!binary && !framed)
+      outBytes += fprintf(output, "]\n"); // print closing bracket
+
+    prog.bytes = framed ? frames.offset : outBytes;
+    fclose(output);
+  }
+
+  remove(ckptName); // run is complete, so checkpoint is no longer needed
+  if (ufName[0] != '\0')
+    remove(ufName);
 
   if(PRINT_EDGE_IDS) {
     if ((edgefile = fopen("edgeList.txt", "a")) == NULL)
@@ -620,6 +1151,26 @@ int main(int argc, char ** argv)
   fclose(edgeFile);
   }
 
+  writeStats(statsName, &prog, thresh, minBloc, maxBloc);
+  delete [] rowPairs;
+  freeTile(&tile);
+
+  if (windowed) {
+    freeIndex(&index);
+    delete [] pairList;
+  }
+
+  if (prefilter == 1)
+    freeMinHash(&mh);
+
+  if (prefilter == 2)
+    freeSubsample(&sub);
+
+  if (prefilter) {
+    delete [] pairList;
+    delete [] pairMark;
+  }
+
   t.stop("\nTimer stopped.");
   cout << t << " seconds.\n" << endl;
 
@@ -629,22 +1180,83 @@ int main(int argc, char ** argv)
   if(LOG_FILE)
     fprintf(logfile, "\nTimer stopped.\n%f seconds.\n", compTime);
 
+  if (compName != NULL) { // write blocs in .bfs format, with time as bfs does
+    writeComponents(compName, &uf, numEdges, logfile);
+
+    FILE *compfile;
+    if ((compfile = fopen(compName, "a")) == NULL)
+      fatal("Components output file could not be opened.\n");
+    fprintf(compfile, "%f\n", compTime);
+    fclose(compfile);
+
+    freeUnionFind(&uf);
+  }
+
   fclose(logfile);
 
+  for (int i = 0; i < numSnps1; i++)
+    freeSparse(&snp1[i]);
+  for (int i = 0; i < numSnps2; i++)
+    freeSparse(&snp2[i]);
+  delete [] snp1;
+  delete [] snp2;
+
+  if (exact) {
+    delete [] ef1;
+    delete [] ef2;
+  }
+
   return 1;
 }
 
 
 
-void format(char* filename, char** data1, char** data2, char** allele, double** freq1, double** freq2, int numSnps, int numInd, int start1, int end1, int start2, int end2, char* logfileName, int numheadrows, int numheadcols, int printFreq) // read in and format input data
+struct CodeSink // where the genotype codes of each SNP go as input is reread
+{
+  int start[2], end[2]; // SNPs in each set (indices in input file)
+  SparseSnp *snp[2]; // counts and lists of each set
+  char **data[2]; // dense rows of each set (NULL for sparse SNPs)
+  int *filled[2]; // entries of each list filled so far
+};
+
+
+static void countCode(int s, int, char code, void *arg) // add code to counts of SNP s
+{
+  CodeSink *sink = (CodeSink *)arg;
+
+  for (int k = 0; k < 2; k++)
+    if ((s >= sink->start[k]) && (s <= sink->end[k]))
+      sink->snp[k][s - sink->start[k]].count[(int)code]++;
+}
+
+
+static void storeCode(int s, int ind, char code, void *arg) // add code to list or row of SNP s
+{
+  CodeSink *sink = (CodeSink *)arg;
+
+  for (int k = 0; k < 2; k++)
+    if ((s >= sink->start[k]) && (s <= sink->end[k])) {
+      int i = s - sink->start[k]; // SNP in set
+      SparseSnp *snp = &sink->snp[k][i];
+
+      if (!snp->sparse)
+	sink->data[k][i][ind] = code;
+
+      else if (code != snp->common) { // individuals arrive in order
+	snp->ind[sink->filled[k][i]] = ind;
+	snp->code[sink->filled[k][i]++] = code;
+      }
+    }
+}
+
+
+void format(char* filename, char** data1, char** data2, SparseSnp* snp1, SparseSnp* snp2, float maxFrac, char (*allele)[2], FreqVec* freq1, FreqVec* freq2, int numSnps, int numInd, int start1, int end1, int start2, int end2, char* logfileName, int numheadrows, int numheadcols, int printFreq) // read in and format input data
 {
   if (!QUIET)
     cout << "\nReading in and formatting data...\n" << endl;
 
-  FILE *input, *logfile;
-  char strng[200]; // temporary string storage
-  int ascii1; // temp storage for ascii value of first allele
-  int ascii2; // temp storage for ascii value of second allele
+  FILE *logfile;
+  char error[200]; // reason input couldn't be read
   long int totalNumMissing1 = 0; // count total number of missing values in first set
   long int totalNumMissing2 = 0; // count total number of missing values in second set
 
@@ -652,21 +1264,6 @@ void format(char* filename, char** data1, char** data2, char** allele, double**
   int numSnps1 = end1 - start1 + 1; 
   int numSnps2 = end2 - start2 + 1;
 
-  // set number of rows and columns of data in input file
-  int numInRows, numInCols;
-
-  // if each row represents an individual (e.g. Plink format)
-  if (ROWS_R_SNPS == 0) {
-    numInRows = numInd;
-    numInCols = numSnps;
-  }
-
-  // if each row represents a SNP (e.g. HapMap format)
-  if (ROWS_R_SNPS == 1) {
-    numInRows = numSnps;
-    numInCols = numInd;
-  }
-
   // open logfile
   if ((logfile = fopen(logfileName, "a")) == NULL)
       fatal("Log file could not be opened.\n");
@@ -676,164 +1273,19 @@ void format(char* filename, char** data1, char** data2, char** allele, double**
   
   cout << "\nReading in data..." << endl;
 
-  if ((input = fopen(filename, "r")) == NULL)
-    fatal("Input file could not be opened.\n");
-
-  // read in data and determine format  
-
-  int space = 0; // set to 1 if space between alleles in input
-  int slash = 0; // set to 1 if slash mark between alleles in input
-  int format = 0; // set to 1 once format is determined
-
-  if(0) { // print out names of individuals and terminate program
-    fatal("Need to fix");
-    long int numCols = 2*numSnps + numheadcols;
-    for (int i = 0; i < numInd; i++)
-      for (int j = 0; j < numCols; j++) {
-	fscanf(input, "%s", strng); 
-	if (j == 1)
-	  cout << strng << endl;
-      }
-    exit(1);
-  }
-
-  // read in header rows and disregard
-  for (int i = 0; i < numheadrows; i++)
-    for (int j = 0; j < numheadcols + numInCols; j++)
-      fscanf(input, "%s", strng); 
-
-  // read in data
-  for (int i = 0; i < numInRows; i++) {
-    if (format)
-      break; // already determined format
-
-    for (int j = 0; j < numheadcols; j++) 
-      fscanf(input, "%s", strng); // read in and disregard header columns
-
-    for (int j = 0; j < numInCols; j++) {
-      if(feof(input))
-	fatal("Input file is missing data");
-
-      fscanf(input, "%s", strng);
-      //cout << i << ", " << j << ": " << strng << endl;
-
-      ascii1 = strng[0]; // find ascii value of first char
-
-      if ((ascii1 != 48) && (ascii1 != 78)) // not 'N' or '0'
-	if(ascii1 != MISSING_SYMBOL) // not customized missing symbol
-	if ((ascii1 != 63) && (ascii1 != 88)) { // not '?' or 'X'
-	
-	  if ((int)strng[1] == 47) // second char is a '/'
-	    slash = 1;
-	  
-	  else if ((int)strng[1] < 65) // second char is not a letter
-	    space = 1; // space between chars
-	  
-	  format = 1;
-	  break; // determined format
-	}
-    }
-  }
-  
-  // reread file and determine alleles for each SNP
-
-  rewind(input); // start over at beginning of file
-
-  // read in header rows and disregard
-  for (int i = 0; i < numheadrows; i++)
-    for (int j = 0; j < numheadcols + numInCols; j++)
-      fscanf(input, "%s", strng); 
-
-  // read in data
-  for (int i = 0; i < numInRows; i++) {
-    for (int j = 0; j < numheadcols; j++) 
-      fscanf(input, "%s", strng); // read in and disregard header columns
-
-    for (int j = 0; j < numInCols; j++) {
-      if(feof(input))
-	fatal("Input file is missing data");
-
-      fscanf(input, "%s", strng);
-      //cout << i << ", " << j << ": " << strng << endl;
+  // map input file into memory, where it is read by the genotype
+  // functions shared with carriers and libblocbuster
+  GenotypeText input; // contents of input file
 
-      ascii1 = strng[0]; // find ascii value of first char
-
-      if (space) {
-	fscanf(input, "%s", strng); // read in second allele
-	ascii2 = strng[0]; // find ascii value of first char
-	
-      }
-      
-      if (!space) { // no space, so second allele is in current string
-	if (slash) 
-	  ascii2 = strng[2]; // second allele is third char, after '/'
-	else
-	  ascii2 = strng[1]; // second allele is second char
+  if (!mapText(filename, &input))
+    fatal("Input file could not be opened.\n");
 
-	if ((ascii1 == 48) || (ascii1 == 78)) // missing data
-	  ascii2 = 78; // set to missing as might have 'NA' in input
+  GenotypeLayout layout = {numInd, numSnps, numheadrows, numheadcols, ROWS_R_SNPS};
 
-	if(ascii1 == MISSING_SYMBOL) // customized missing symbol
-	  ascii2 = 78; // set to missing 
-      }
-      
-      // check validity of data
-      if ((ascii1 != 65) && (ascii1 != 67)) // not 'A' or 'C'
-	if ((ascii1 != 71) && (ascii1 != 84))  // not 'G' or 'T' 
-	  if ((ascii1 != 73) && (ascii1 != 68))  // not 'I' or 'D'
-	    if ((ascii1 != 48) && (ascii1 != 78))  // not 'N' or '0'
-	      if(ascii1 != MISSING_SYMBOL) // not customized missing symbol
-	      if ((ascii1 != 63) && (ascii1 != 88)) { // not '?' or 'X'
-		cout << i << ", " << j << ": " << endl;
-		cout << (char)ascii1 << endl;
-		fatal("Improper input data");
-	      }
-      
-      if ((ascii2 != 65) && (ascii2 != 67)) // not 'A' or 'C'
-	if ((ascii2 != 71) && (ascii2 != 84))  // not 'G' or 'T' 
-	  if ((ascii2 != 73) && (ascii2 != 68))  // not 'I' or 'D'
-	    if ((ascii2 != 48) && (ascii2 != 78)) // not 'N' or '0'
-	      if(ascii2 != MISSING_SYMBOL) // not customized missing symbol
-	      if ((ascii1 != 63) && (ascii1 != 88)) { // not '?' or 'X'
-		cout << i << ", " << j << ": " << endl;
-		cout << (char)ascii2 << endl;
-		fatal("Improper input data");
-	      }
-      
-      // determine alleles for each genotype
-
-      int currentSNP; // get current SNP number
-      if (ROWS_R_SNPS == 0)
-	currentSNP = j; // current SNP is current column number
-      if (ROWS_R_SNPS == 1)
-	currentSNP = i; // current SNP is current row number
-
-      if ((ascii1 != 48) && (ascii1 != 78))  // not 'N' or '0'
-	if(ascii1 != MISSING_SYMBOL) // not customized missing symbol
-	  if ((ascii1 != 63) && (ascii1 != 88)) { // not '?' or 'X'
-	    if(allele[currentSNP][0] == '0') // '0' so haven't found first allele yet
-	      allele[currentSNP][0] = (char)ascii1;
-	    else if (allele[currentSNP][1] == '0') // '0' so haven't found second allele yet
-	      if (ascii1 != (int)allele[currentSNP][0])
-		allele[currentSNP][1] = (char)ascii1; // found second allele
-	    
-	    if (allele[currentSNP][1] == '0') // '0' so haven't found second allele yet
-	      if (ascii2 != (int)allele[currentSNP][0])
-		allele[currentSNP][1] = (char)ascii2; // found second allele
-	    
-	    //cout << (char)ascii1 << (char)ascii2 << " "; 
-	    //cout << allele[currentSNP][0] << allele[currentSNP][1] << endl;
-	  }
-    }
-  }
-  
-  // order alleles alphabetically
-  for (int i = 0; i < numSnps; i++) 
-    if (allele[i][0] > allele[i][1]) { // exchange values
-      int temp = allele[i][0];
-      allele[i][0] = allele[i][1];
-      allele[i][1] = temp;
-    }
+  // determine alleles for each SNP, in alphabetical order
+  if (!findAlleles(input.data, input.size, &layout, allele, error))
+    fatal(error);
+  sortAlleles(allele, numSnps);
 
   // check for only one allele for a SNP
   int oneAllele = 0; // number of SNPs with only one allele
@@ -856,215 +1308,43 @@ void format(char* filename, char** data1, char** data2, char** allele, double**
     }
   }
 
-  // check for end of file
-  if (!feof(input)){
-    fscanf(input, "%s", strng);
-    if (!feof(input))
-      fatal("Unread data in input file");
-  }
-
-  // allocate space for tallies of individuals without missing genotypes
-  int *haveGenotype1; // first set of SNPs
-  int *haveGenotype2; // second set of SNPs
-
-  if ((haveGenotype1 = new int[numSnps1]) == NULL)
-    fatal("memory not allocated");
-
-  if ((haveGenotype2 = new int[numSnps2]) == NULL)
-    fatal("memory not allocated");
-
-  // initialize values to number of individuals and subtract missing
-  for (int i = 0; i < numSnps1; i++)
-    haveGenotype1[i] = numInd;
-
-  for (int i = 0; i < numSnps2; i++)
-    haveGenotype2[i] = numInd;
-
-  // reread data again and record values
-  rewind(input); // rewind to beginning of file
-
-  // read in header rows and disregard
-  for (int i = 0; i < numheadrows; i++)
-    for (int j = 0; j < numheadcols + numInCols; j++)
-      fscanf(input, "%s", strng); 
+  // reread data twice, first counting the codes of each SNP in either set
+  // and then storing them, so that each SNP is held either as a list or
+  // as a dense row and no other rows are needed
+  CodeSink sink = {{start1, start2}, {end1, end2}, {snp1, snp2}, {data1, data2}, {NULL, NULL}};
+  int numSnpsIn[2] = {numSnps1, numSnps2}; // SNPs in each set
 
-  // read in data
-  for (int i = 0; i < numInRows; i++) {
-    for (int j = 0; j < numheadcols; j++) 
-      fscanf(input, "%s", strng); // read in and disregard header columns
+  for (int k = 0; k < 2; k++) {
+    if ((sink.filled[k] = new int[numSnpsIn[k]]) == NULL)
+      fatal("memory not allocated");
 
-    for (int j = 0; j < numInCols; j++) {
-      fscanf(input, "%s", strng);
-      //cout << i << ", " << j << ": " << strng << endl;
+    for (int i = 0; i < numSnpsIn[k]; i++)
+      for (int c = 0; c < 4; c++)
+	sink.snp[k][i].count[c] = 0;
+  }
 
-      ascii1 = strng[0]; // find ascii value of first char
+  if (!scanGenotypes(input.data, input.size, &layout, allele, countCode, &sink, error))
+    fatal(error);
 
-      if (space) {
-	fscanf(input, "%s", strng); // read in second allele
-	ascii2 = strng[0]; // find ascii value of first char
-	
-      }
-      
-      if (!space) { // no space, so second allele is in current string
-	if (slash) 
-	  ascii2 = strng[2]; // second allele is third char, after '/'
-	else
-	  ascii2 = strng[1]; // second allele is second char
+  for (int k = 0; k < 2; k++)
+    for (int i = 0; i < numSnpsIn[k]; i++) {
+      sink.filled[k][i] = 0;
+      sink.data[k][i] = NULL;
 
-	if ((ascii1 == 48) || (ascii1 == 78)) // missing data
-	  ascii2 = 78; // set to missing as might have 'NA' in input
+      if (!planSparse(numInd, maxFrac, &sink.snp[k][i]))
+	if ((sink.data[k][i] = new char[numInd]) == NULL)
+	  fatal("Memory not allocated");
+    }
 
-	if(ascii1 == MISSING_SYMBOL) // customized missing symbol
-	  ascii2 = 78; // set to missing
-      }
-      
-      // assign index depending upon whether SNPs are represented by rows or columns
-    
-      int currentSNP; // get current SNP number
-      int currentInd; // get current individual number
-    
-      if (ROWS_R_SNPS == 0) {
-	currentSNP = j; // current SNP is current column number
-	currentInd = i; // current individual is row number
-      }
+  if (!scanGenotypes(input.data, input.size, &layout, allele, storeCode, &sink, error))
+    fatal(error);
 
-      if (ROWS_R_SNPS == 1) {
-	currentSNP = i; // current SNP is current row number
-	currentInd = j; // current individual is column number
-      }
+  for (int k = 0; k < 2; k++)
+    delete [] sink.filled[k];
 
-      // check validity of input data
-      
-      if ((ascii1 != (int)allele[currentSNP][0]) && (ascii1 != (int)allele[currentSNP][1])) // not one of the alleles 
-	  if ((ascii1 != 48) && (ascii1 != 78)) // not 'N' or '0'
-	    if(ascii1 != MISSING_SYMBOL) // not customized missing symbol
-	    if ((ascii1 != 63) && (ascii1 != 88)) { // not '?' or 'X'
-	      cout << "SNP " << currentSNP+1 << " for individual " << currentInd+1 << " (" << allele[currentSNP][0] << allele[currentSNP][1] << ")" << endl;
-	      cout << "Doesn't match: " << (char)ascii1 << endl;
-	      fatal("***Invalid data treated as missing.  Are there more than 2 alleles?***");
-	      ascii1 = 48; // treat as missing data
-	    }
-      
-      if ((ascii2 != (int)allele[currentSNP][0]) && (ascii2 != (int)allele[currentSNP][1])) // not one of the alleles 
-	if ((ascii2 != 48) && (ascii2 != 78)) // not 'N' or '0'
-	  if(ascii2 != MISSING_SYMBOL) // not customized missing symbol
-	  if ((ascii2 != 63) && (ascii2 != 88)) { // not '?' or 'X'
-	    cout << "SNP " << currentSNP+1 << " for individual " << currentInd+1 << " (" << allele[currentSNP][0] << allele[currentSNP][1] << ")" << endl;
-	    cout << "Doesn't match: " << (char)ascii2 << endl;
-	    fatal("***Invalid data treated as missing.  Are there more than 2 alleles?***");
-	    ascii2 = 48; // treat as missing data
-	  }
-      
-      // assign codes for genotypes
-      // record if in first set of SNPs
-      if((currentSNP >= start1) && (currentSNP <= end1)) { // record value
-	int k = currentSNP - start1; // index in data matrix
-	
-	if ((k < 0) || (k >= numSnps1))
-	  fatal("Error in data matrix");
-	
-	if ((ascii1 == 48) || (ascii1 == 78)) { // 'N' or '0', mark as 3
-	  data1[k][currentInd] = 3; // table with numSnps rows
-	  haveGenotype1[k]--; // one less individual with genotype given
-	  totalNumMissing1++; // count total number missing
-	}
-	
-	else
-	  if(ascii1 == MISSING_SYMBOL) { // customized missing symbol
-	    data1[k][currentInd] = 3; // table with numSnps rows
-	    haveGenotype1[k]--; // one less individual with genotype given
-	    totalNumMissing1++; // count total number missing
-	  }
-
-	  else
-	    if ((ascii1 == 63) || (ascii1 == 88)) { // '?' or 'X', mark as 3
-	      data1[k][currentInd] = 3; // table with numSnps rows
-	      haveGenotype1[k]--; // one less individual with genotype given
-	      totalNumMissing1++; // count total number missing
-	    }
-	
-	    else
-	      if (ascii1 != ascii2) { // heterozygous
-		data1[k][currentInd] = 1;
-		freq1[k][0]++; // another allele in data
-		freq1[k][1]++; // another allele in data
-	      } 
-	
-	      else
-		if (ascii1 == (int)allele[currentSNP][0]) { // homozygote in first allele
-		  data1[k][currentInd] = 0;
-		  freq1[k][0]+= 2; // two more alleles in data
-		}
-	
-		else
-		  if (ascii1 == (int)allele[currentSNP][1]) { // homozygote in second allele
-		    data1[k][currentInd] = 2;
-		    freq1[k][1]+= 2; // two more alleles in data
-		  }
-      }
+  unmapText(&input);
 
-      //cout << currentSNP << ", start2 = " << start2 << ", end2 = " << end2 << endl;
-    
-      // record if in second set of SNPs
-      if((currentSNP >= start2) && (currentSNP <= end2)) { // record value
-	int k = currentSNP - start2; // index in data matrix
-	
-	if ((k < 0) || (k >= numSnps2))
-	  fatal("Error in data matrix");
-	
-	if ((ascii1 == 48) || (ascii1 == 78)) { // 'N' or '0', mark as 3
-	  data2[k][currentInd] = 3; // table with numSnps rows
-	  haveGenotype2[k]--; // one less individual with genotype given
-	  totalNumMissing2++; // count total number missing
-	  continue;
-	}
-	
-	if(ascii1 == MISSING_SYMBOL) { // customized missing symbol
-	  data2[k][currentInd] = 3; // table with numSnps rows
-	  haveGenotype2[k]--; // one less individual with genotype given
-	  totalNumMissing2++; // count total number missing
-	  continue;
-	}
-	
-	if ((ascii1 == 63) || (ascii1 == 88)) { // '?' or 'X', mark as 3
-	  data2[k][currentInd] = 3; // table with numSnps rows
-	  haveGenotype2[k]--; // one less individual with genotype given
-	  totalNumMissing2++; // count total number missing
-	  continue;
-	}
-	
-	if (ascii1 != ascii2) { // heterozygous
-	  data2[k][currentInd] = 1;
-	  freq2[k][0]++; // another allele in data
-	  freq2[k][1]++; // another allele in data
-	  continue;
-	} 
-	
-	if (ascii1 == (int)allele[currentSNP][0]) { // homozygote in first allele
-	  data2[k][currentInd] = 0;
-	  freq2[k][0]+= 2; // two more alleles in data
-	  continue;
-	}
-	
-	if (ascii1 == (int)allele[currentSNP][1]) { // homozygote in second allele
-	  data2[k][currentInd] = 2;
-	  freq2[k][1]+= 2; // two more alleles in data
-	  continue;
-	}
-      }
-    }
-  }
-      
-  // check for end of file
-  if (!feof(input)){
-    fscanf(input, "%s", strng);
-    if (!feof(input))
-      fatal("Unread data in input file");
-  }
-
-  fclose(input);
-
-  // convert frequency counts to frequency factors
+  // convert frequencies to frequency factors
 
   // print out frequencies, if parameter set
   FILE *tempFreq;
@@ -1078,24 +1358,23 @@ void format(char* filename, char** data1, char** data2, char** allele, double**
     cout << "Frequencies of alleles in first set:" << endl;
 
   for (int i = 0; i < numSnps1; i++) {
+    double f[2]; // frequency of each allele
+
+    countFreq(snp1[i].count, numInd, f);
+    totalNumMissing1 += snp1[i].count[3];
 
     if (printFreq)
       fprintf(tempFreq, "%d", i+1);
  
     for (int j = 0; j < 2; j++) {
-      freq1[i][j] /= 2 * haveGenotype1[i]; // divide by 2*number without missing
-
       if(VERBOSE) 
-	cout << freq1[i][j] << endl;
+	cout << f[j] << endl;
 
       if (printFreq)
-	fprintf(tempFreq, " %c %f", allele[i][j], freq1[i][j]);
+	fprintf(tempFreq, " %c %f", allele[i][j], f[j]);
      
       // calculate frequency factor
-      freq1[i][j] = 1 - (freq1[i][j] / FREQWT); 
-
-      if(0) 
-	cout << freq1[i][j] << endl;
+      freq1->f[j][i] = 1 - (f[j] / FREQWT); 
     }
 
     if (printFreq)
@@ -1106,66 +1385,47 @@ void format(char* filename, char** data1, char** data2, char** allele, double**
     cout << "Frequencies of alleles in second set:" << endl;
 
   for (int i = 0; i < numSnps2; i++) {
+    double f[2]; // frequency of each allele
 
-    //if (printFreq)  // removed as only print out first set of frequencies
-    //fprintf(tempFreq, "%d", i+1);
+    countFreq(snp2[i].count, numInd, f);
+    totalNumMissing2 += snp2[i].count[3];
  
     for (int j = 0; j < 2; j++) {
-      freq2[i][j] /= 2 * haveGenotype2[i]; // divide by 2*number without missing
-
       if(VERBOSE) 
-	cout << freq2[i][j] << endl;
-
-      //if (printFreq)
-      //fprintf(tempFreq, " %c %f", allele[i][j], freq[i][j]);
+	cout << f[j] << endl;
      
       // calculate frequency factor
-      freq2[i][j] = 1 - (freq2[i][j] / FREQWT); 
-
-      if(0) 
-	cout << freq2[i][j] << endl;
+      freq2->f[j][i] = 1 - (f[j] / FREQWT); 
     }
-
-    //if (printFreq)
-    //fprintf(tempFreq, "\n");
   }
 
   if (printFreq)
     fclose(tempFreq);
 
   if (VERBOSE) {
+    char *codes; // codes of a SNP, from either form
+
+    if ((codes = new char[numInd]) == NULL)
+      fatal("memory not allocated");
+
     cout << "Encoded data for start SNPs (number of alleles with highest alphabetic order):"<< endl;
     for (int i = 0; i < numSnps1; i++) {
+      expandSnp(&snp1[i], data1[i], numInd, codes);
       for (int j = 0; j < numInd; j++)
-	cout << (int)data1[i][j] << " ";
+	cout << (int)codes[j] << " ";
       cout << endl;
     }
 
     cout << "Encoded data for end SNPs (number of alleles with highest alphabetic order):"<< endl;
     for (int i = 0; i < numSnps2; i++) {
+      expandSnp(&snp2[i], data2[i], numInd, codes);
       for (int j = 0; j < numInd; j++)
-	cout << (int)data2[i][j] << " ";
+	cout << (int)codes[j] << " ";
       cout << endl;
     }
-  }
-  
-  // check validity of data
-  for (int i = 0; i < numSnps1; i++) 
-    for (int j = 0; j < numInd; j++)
-      if (data1[i][j] > 3) {
-	cout << "Data1 " << i << ", " << j << ": " << (int)data1[i][j] << endl;
-	fatal("Invalid value in data matrix");
-      }
 
-  for (int i = 0; i < numSnps2; i++) 
-    for (int j = 0; j < numInd; j++)
-      if (data2[i][j] > 3) {
-	cout << "Data2 " << i << ", " << j << ": " << (int)data2[i][j] << endl;
-	fatal("Invalid value in data matrix");
-      }
-  
-  delete [] haveGenotype1;
-  delete [] haveGenotype2;
+    delete [] codes;
+  }
 
   cout << totalNumMissing1 << " and " << totalNumMissing2 << " missing values in first and second SNP sets, respectively." << endl;
 
@@ -1177,6 +1437,91 @@ void format(char* filename, char** data1, char** data2, char** allele, double**
 }
 
 
+void printEdge(FILE *output, FILE *logfile, int source, int target, float weight, int numNodes, long int *numEdges, long int *bytes, UnionFind *uf, int binary, FrameWriter *frames) // print edge to output file
+{
+  if ((weight > 1.0 + TOL) || (weight < 0.0 - TOL)) {
+    cout << "\nWarning: CCC value is " << weight << endl;
+    //fatal("Invalid CCC value");
+
+    if(LOG_FILE)
+      fprintf(logfile, "\nWarning: CCC value is %f\n", weight);
+  }
+
+  if ((output != NULL) && (frames != NULL)) { // compressed in frames
+    if (!frameEdge(frames, source, target, weight))
+      fatal("Output file could not be written.\n");
+  }
+
+  else if ((output != NULL) && binary) { // 16-bit weight
+    if (!writeBinaryEdge(output, source, target, quantiseWeight(weight)))
+      fatal("Output file could not be written.\n");
+    *bytes += BINARY_EDGE_BYTES;
+  }
+
+  else if (output != NULL) { // NULL when only components are found
+    int n = fprintf(output, "\tedge\n\t[\n\tsource %d\n\ttarget %d\n\tweight %f\n\t]\n", source, target, weight);
+    if (n < 0)
+      fatal("Output file could not be written.\n");
+    *bytes += n; // ftell fails on pipes, so bytes are counted
+  }
+  (*numEdges)++;
+
+  if (uf != NULL)
+    unionEdge(uf, source, target);
+
+  if(PRINT_EDGE_IDS) {
+    FILE *edgefile;
+    if ((edgefile = fopen("edgeList.txt", "a")) == NULL)
+      fatal("'edgeList.txt' file could not be opened.\n");
+    fprintf(edgefile, "%d ", source*numNodes + target);
+    fclose(edgefile);
+  }
+}
+
+
+void reportPermutations(const char *fileName, PermResult *result, int numPerms, float thresh, unsigned long int seed, FILE *logfile)
+{
+  FILE *output;
+
+  if ((output = fopen(fileName, "w")) == NULL)
+    fatal("Permutation output file could not be opened.\n");
+
+  fprintf(output, "seed\t%lu\n", seed);
+  fprintf(output, "replicate\tmaxCCC\tedges\n");
+
+  int numWithEdges = 0; // replicates with at least one edge
+  double sumEdges = 0.0;
+  float *maxima; // maximum CCC of each replicate, to be sorted
+
+  if ((maxima = new float[numPerms]) == NULL)
+    fatal("memory not allocated");
+
+  for (int p = 0; p < numPerms; p++) {
+    fprintf(output, "%d\t%f\t%ld\n", p+1, result[p].maxBloc, result[p].numEdges);
+    maxima[p] = result[p].maxBloc;
+    sumEdges += result[p].numEdges;
+    if (result[p].numEdges > 0)
+      numWithEdges++;
+  }
+  fclose(output);
+
+  sort(maxima, maxima + numPerms);
+  int upper = (int)ceil(0.95 * numPerms) - 1; // 95th percentile of maxima
+
+  cout << "\nMaximum CCC over replicates ranges from " << maxima[0] << " to " << maxima[numPerms-1] << ", 95th percentile " << maxima[upper] << endl;
+  cout << numWithEdges << " of " << numPerms << " replicates have edges with values >= " << thresh << ", " << sumEdges / numPerms << " edges on average" << endl;
+  cout << "Replicates written to '" << fileName << "'." << endl;
+
+  if(LOG_FILE) {
+    fprintf(logfile, "\nMaximum CCC over replicates ranges from %f to %f, 95th percentile %f\n", maxima[0], maxima[numPerms-1], maxima[upper]);
+    fprintf(logfile, "%d of %d replicates have edges with values >= %f, %f edges on average\n", numWithEdges, numPerms, thresh, sumEdges / numPerms);
+    fprintf(logfile, "Replicates written to '%s'.\n", fileName);
+  }
+
+  delete [] maxima;
+}
+
+
 void checkConstants()
 {
   // check Boolean values 
@@ -1208,13 +1553,28 @@ void checkConstants()
   if((FREQ != 0) && (FREQ != 1))
     fatal("FREQ value in bloc.h should be zero or one.");
 
+  if((SPARSE != 0) && (SPARSE != 1))
+    fatal("SPARSE value in bloc.h should be zero or one.");
+
   // check other values
   if ((FREQWT > 1.5 + TOL) || (FREQWT < 1.5 - TOL))
     warning("Default frequency weight is 1.5.  Check FREQWT in bloc.h");
  
+  if ((FREQWT_NUM < 1) || (FREQWT_DEN < 1) || (fabs(FREQWT - (float)FREQWT_NUM / (float)FREQWT_DEN) > TOL))
+    fatal("FREQWT_NUM / FREQWT_DEN in bloc.h should equal FREQWT.");
+ 
   if((NOMISS > 1.0 + TOL) || (NOMISS < 0.0 - TOL))
     warning("Invalid value for NOMISS in bloc.h.");
  
+  if ((SPARSE_FRAC < 0.0) || (SPARSE_FRAC > 1.0 + TOL))
+    fatal("SPARSE_FRAC in bloc.h should be between zero and one.");
+
+  if ((MINHASH_BANDS < 1) || (MINHASH_ROWS < 1))
+    fatal("MINHASH_BANDS and MINHASH_ROWS in bloc.h should be at least one.");
+
+  if ((MINHASH_CARRIERS <= 0.0) || (MINHASH_CARRIERS > 1.0 + TOL))
+    fatal("MINHASH_CARRIERS in bloc.h should be above zero and at most one.");
+ 
   if((TOL > 0.001) || (TOL < -0.0000001))
     fatal("Invalid value for TOL in bloc.h.");
 }
@@ -13,8 +13,13 @@
 #include <stdio.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 
 #include "timer.h"
 
@@ -33,24 +38,55 @@ const int TWONODE = 1; // create a network with two nodes for each SNP (Boolean)
 const int PRINTFREQ = 0; // set to 1 to print out frequencies to "temp.freq" (Boolean)
 const int FREQ = 1; // use frequency information in correlation value (Boolean)
 const float FREQWT = 1.5; // weight used for frequency factor (1.5)
+const int FREQWT_NUM = 3; // FREQWT as a fraction, used for exact evaluation
+const int FREQWT_DEN = 2;
 
 const float NOMISS = 0.5; // minimum fraction of individuals without missing relationships
                           // if too many missing, a warning message is printed
 const int WARN_MISS = 0; // set to 1 to print these warning messages (Boolean)
 
+const int SPARSE = 1; // store rare-variant SNPs as lists of individuals (Boolean)
+const float SPARSE_FRAC = 0.05; // max fraction of individuals without most common
+                                // genotype for a SNP to be stored as a list
+
 const int SCREEN_INPUT = 0; // set to 1 to be prompted for # of header rows/cols (Boolean)
 const int LOG_FILE = 1; // set to 1 to record screen output to log file (Boolean)
 
+const int PAIR_BLOCK = 256; // number of pairs evaluated together in a tile
+const int ALIGNMENT = 64; // byte alignment of arrays used in pair loop
+
+const int CHECKPOINT_INTERVAL = 600; // seconds between checkpoints (0 for none)
+const int PROGRESS_INTERVAL = 60; // seconds between progress reports in log file (0 for none)
+
+const int MINHASH_BANDS = 20; // bands in min-hash signature of each allele's carriers
+const int MINHASH_ROWS = 4; // values in each band (fewer gives more candidate pairs)
+const float MINHASH_CARRIERS = 0.5; // alleles carried by at least this fraction are bounded, not bucketed
+const int AUDIT_ROWS = 100; // rows sampled to measure recall of candidate pairs
+const float SUBSAMPLE_MARGIN = 0.1; // margin below threshold for estimates on a subsample
+
 // the following can be adjusted if needed
 const int MAX_NUM_EDGES = 10000000; // maximum number of edges output
 const int MAXNUMHEADERS = 200; // maximum number of header rows or columns
 const int MAX_NUM_INDIVIDUALS = 1000000; // maximum number of individuals
 const int MAX_NUM_SNPS = 10000000; // maximum number of SNPs
+const int MAX_NUM_GROUPS = 64; // maximum number of groups in a group mapping file
+const int POS_CHROM_COL = 3; // column of SNP info file holding chromosome (from 1)
+const int POS_BP_COL = 4; // column of SNP info file holding base pair position
 const double TOL = 0.00001; // tolerance
 
 
 
+struct FreqVec // frequency factors for a set of SNPs
+{
+  double *f[2]; // aligned arrays for alleles lowest [0] and highest [1] alphabetically
+};
+
+
 inline void warning(const char* p) { fprintf(stderr,"Warning: %s \n",p); }
 inline void fatal(const char* string) {fprintf(stderr,"\nFatal: %s\n\n",string); exit(1); }
+inline void* alignedAlloc(size_t bytes) { void *p; if (posix_memalign(&p, ALIGNMENT, bytes) != 0) fatal("memory not allocated"); return p; }
+// flush file through to the disk, so it survives a crash of the node;
+// pipes can't be synced and count as written
+inline int syncFile(FILE *f) { return (fflush(f) == 0) && !ferror(f) && ((fsync(fileno(f)) == 0) || (errno == EINVAL)); }
 
 #endif
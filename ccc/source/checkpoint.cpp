@@ -0,0 +1,129 @@
+/****************************************************************************
+*
+*	checkpoint.cpp:	Write and read checkpoints so that a long ccc
+*                       run can be resumed after it is interrupted.
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include "checkpoint.h"
+#include <fcntl.h>
+
+using namespace std;
+
+void writeCheckpoint(const char *fileName, const Checkpoint *ckpt)
+{
+  FILE *output;
+  char tempName[220]; // checkpoint is written here first, then renamed
+
+  sprintf(tempName, "%s.tmp", fileName);
+
+  if ((output = fopen(tempName, "w")) == NULL)
+    fatal("Checkpoint file could not be opened.\n");
+
+  // floating point values are written in hexadecimal so they are exact
+  fprintf(output, "ccc checkpoint\n");
+  fprintf(output, "input %s\n", ckpt->input);
+  fprintf(output, "threshold %a\n", (double)ckpt->thresh);
+  fprintf(output, "individuals %d\n", ckpt->numInd);
+  fprintf(output, "snps %d\n", ckpt->numSnps);
+  fprintf(output, "ranges %d %d %d %d\n", ckpt->start1, ckpt->end1, ckpt->start2, ckpt->end2);
+  fprintf(output, "exact %d\n", ckpt->exact);
+  fprintf(output, "outputs %d %d %d %d\n", ckpt->components, ckpt->gml, ckpt->binary, ckpt->framed);
+  fprintf(output, "window %ld\n", ckpt->window);
+  fprintf(output, "prefilter %d %d %a\n", ckpt->prefilter, ckpt->subsample, (double)ckpt->margin);
+  fprintf(output, "rowsDone %d\n", ckpt->rowsDone);
+  fprintf(output, "numEdges %ld\n", ckpt->numEdges);
+  fprintf(output, "maxBloc %a\n", (double)ckpt->maxBloc);
+  fprintf(output, "minBloc %a\n", (double)ckpt->minBloc);
+  fprintf(output, "offset %ld\n", ckpt->offset);
+  fprintf(output, "end\n");
+
+  if (!syncFile(output))
+    fatal("Checkpoint file could not be written.\n");
+  fclose(output);
+
+  if (rename(tempName, fileName) != 0)
+    fatal("Checkpoint file could not be renamed.\n");
+
+  // sync the directory too, so the rename itself reaches the disk
+  char dirName[220];
+  sprintf(dirName, "%s", fileName);
+  char *slash = strrchr(dirName, '/');
+  if (slash == NULL)
+    sprintf(dirName, ".");
+  else if (slash == dirName)
+    dirName[1] = '\0'; // file is in the root directory
+  else
+    *slash = '\0';
+
+  int dir = open(dirName, O_RDONLY);
+  if (dir >= 0) {
+    fsync(dir);
+    close(dir);
+  }
+}
+
+
+int readCheckpoint(const char *fileName, Checkpoint *ckpt)
+{
+  FILE *input;
+  char strng[200]; // temporary string storage
+  double value; // temporary storage for floating point values
+
+  if ((input = fopen(fileName, "r")) == NULL)
+    return 0; // no checkpoint available
+
+  if ((fscanf(input, "%199s", strng) != 1) || (strcmp(strng, "ccc") != 0))
+    fatal("Invalid checkpoint file");
+  fscanf(input, "%199s", strng); // 'checkpoint'
+
+  if (fscanf(input, "%199s %199s", strng, ckpt->input) != 2)
+    fatal("Invalid checkpoint file");
+
+  if (fscanf(input, "%199s %la", strng, &value) != 2)
+    fatal("Invalid checkpoint file");
+  ckpt->thresh = (float)value;
+
+  if ((fscanf(input, "%199s %d", strng, &ckpt->numInd) != 2) || (fscanf(input, "%199s %d", strng, &ckpt->numSnps) != 2))
+    fatal("Invalid checkpoint file");
+
+  if (fscanf(input, "%199s %d %d %d %d", strng, &ckpt->start1, &ckpt->end1, &ckpt->start2, &ckpt->end2) != 5)
+    fatal("Invalid checkpoint file");
+
+  if (fscanf(input, "%199s %d", strng, &ckpt->exact) != 2)
+    fatal("Invalid checkpoint file");
+
+  if (fscanf(input, "%199s %d %d %d %d", strng, &ckpt->components, &ckpt->gml, &ckpt->binary, &ckpt->framed) != 5)
+    fatal("Invalid checkpoint file");
+
+  if (fscanf(input, "%199s %ld", strng, &ckpt->window) != 2)
+    fatal("Invalid checkpoint file");
+
+  if (fscanf(input, "%199s %d %d %la", strng, &ckpt->prefilter, &ckpt->subsample, &value) != 4)
+    fatal("Invalid checkpoint file");
+  ckpt->margin = (float)value;
+
+  if ((fscanf(input, "%199s %d", strng, &ckpt->rowsDone) != 2) || (fscanf(input, "%199s %ld", strng, &ckpt->numEdges) != 2))
+    fatal("Invalid checkpoint file");
+
+  if (fscanf(input, "%199s %la", strng, &value) != 2)
+    fatal("Invalid checkpoint file");
+  ckpt->maxBloc = (float)value;
+
+  if (fscanf(input, "%199s %la", strng, &value) != 2)
+    fatal("Invalid checkpoint file");
+  ckpt->minBloc = (float)value;
+
+  if (fscanf(input, "%199s %ld", strng, &ckpt->offset) != 2)
+    fatal("Invalid checkpoint file");
+
+  if ((fscanf(input, "%199s", strng) != 1) || (strcmp(strng, "end") != 0))
+    fatal("Checkpoint file is incomplete");
+
+  fclose(input);
+
+  return 1;
+}
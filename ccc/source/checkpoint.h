@@ -0,0 +1,50 @@
+// -------------------------------------------------------------------------
+// checkpoint.h -   Header file for checkpointing long ccc runs
+//
+// A checkpoint records the rows of the first SNP set that have been
+// completed, the running tallies and the number of bytes of edge output
+// that were flushed when these rows were done.  Checkpoints are written
+// to a temporary file and renamed, so the file on disk is always whole.
+// The edge output and the temporary file are synced to the disk before
+// the rename, so a checkpoint never points past edges lost in a crash
+// of the node.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _CHECKPOINT_H
+#define _CHECKPOINT_H
+
+#include "bloc.h"
+
+struct Checkpoint
+{
+  // parameters of the run, which must match when resuming
+  char input[200]; // name of genotype input file
+  float thresh; // threshold as given on command line
+  int numInd; // number of individuals
+  int numSnps; // number of SNPs
+  int start1, end1, start2, end2; // SNP ranges (indexed from zero)
+  int exact; // 1 if CCC values are evaluated exactly (Boolean)
+  int components; // 1 if components are found during run (Boolean)
+  int gml; // 1 if edges are written to .gml file (Boolean)
+  int binary; // 1 if edges are written with 16-bit weights (Boolean)
+  int framed; // 1 if edges are written in compressed frames (Boolean)
+  long int window; // window in base pairs (-1 for cross-chromosome, -2 for all pairs)
+  int prefilter; // 0 for all pairs, 1 for min-hash candidates, 2 for subsample estimates
+  int subsample; // individuals in subsample (0 unless prefilter is 2)
+  float margin; // margin below threshold for subsample estimates
+
+  // state after the completed rows
+  int rowsDone; // rows 0 to rowsDone-1 of first SNP set are complete
+  long int numEdges; // edges printed so far
+  float maxBloc; // running maximum (unscaled)
+  float minBloc; // running minimum (unscaled)
+  long int offset; // bytes of edge output flushed to disk
+};
+
+void writeCheckpoint(const char *fileName, const Checkpoint *ckpt); // save state
+int readCheckpoint(const char *fileName, Checkpoint *ckpt); // return 0 if no file
+
+#endif
@@ -0,0 +1,230 @@
+/****************************************************************************
+*
+*	components.cpp:	Union-find structure for finding the connected
+*                       components of the ccc graph as edges are
+*                       printed.
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include "components.h"
+
+using namespace std;
+
+void allocUnionFind(UnionFind *uf, int numNodes)
+{
+  uf->numNodes = numNodes;
+
+  if (((uf->parent = new int[numNodes]) == NULL) || ((uf->rank = new char[numNodes]) == NULL))
+    fatal("memory not allocated");
+  if (((uf->size = new int[numNodes]) == NULL) || ((uf->edges = new long int[numNodes]) == NULL))
+    fatal("memory not allocated");
+
+  for (int i = 0; i < numNodes; i++) {
+    uf->parent[i] = i; // each node is its own component
+    uf->rank[i] = 0;
+    uf->size[i] = 1;
+    uf->edges[i] = 0;
+  }
+}
+
+
+void freeUnionFind(UnionFind *uf)
+{
+  delete [] uf->parent;
+  delete [] uf->rank;
+  delete [] uf->size;
+  delete [] uf->edges;
+}
+
+
+int findRoot(UnionFind *uf, int node)
+{
+  while (uf->parent[node] != node) {
+    uf->parent[node] = uf->parent[uf->parent[node]]; // path halving
+    node = uf->parent[node];
+  }
+
+  return node;
+}
+
+
+void unionEdge(UnionFind *uf, int source, int target)
+{
+  if ((source < 1) || (source > uf->numNodes) || (target < 1) || (target > uf->numNodes))
+    fatal("Node id out of range in union-find");
+
+  int root1 = findRoot(uf, source-1);
+  int root2 = findRoot(uf, target-1);
+
+  if (root1 == root2) { // already in same component
+    uf->edges[root1]++;
+    return;
+  }
+
+  if (uf->rank[root1] < uf->rank[root2]) { // hang shorter tree below taller
+    int temp = root1;
+    root1 = root2;
+    root2 = temp;
+  }
+
+  uf->parent[root2] = root1;
+  uf->size[root1] += uf->size[root2];
+  uf->edges[root1] += uf->edges[root2] + 1;
+
+  if (uf->rank[root1] == uf->rank[root2])
+    uf->rank[root1]++;
+}
+
+
+void saveUnionFind(const char *fileName, const UnionFind *uf, int rowsDone)
+{
+  FILE *output;
+  char tempName[220]; // state is written here first, then renamed
+
+  sprintf(tempName, "%s.tmp", fileName);
+
+  if ((output = fopen(tempName, "wb")) == NULL)
+    fatal("Union-find checkpoint file could not be opened.\n");
+
+  int n = uf->numNodes;
+  fwrite(&n, sizeof(int), 1, output);
+  fwrite(&rowsDone, sizeof(int), 1, output);
+  fwrite(uf->parent, sizeof(int), n, output);
+  fwrite(uf->rank, sizeof(char), n, output);
+  fwrite(uf->size, sizeof(int), n, output);
+  fwrite(uf->edges, sizeof(long int), n, output);
+
+  if (!syncFile(output))
+    fatal("Union-find checkpoint file could not be written.\n");
+  fclose(output);
+
+  if (rename(tempName, fileName) != 0)
+    fatal("Union-find checkpoint file could not be renamed.\n");
+}
+
+
+void loadUnionFind(const char *fileName, UnionFind *uf, int rowsDone)
+{
+  FILE *input;
+  int n, rows; // number of nodes and rows done when state was saved
+
+  if ((input = fopen(fileName, "rb")) == NULL)
+    fatal("Union-find checkpoint file could not be opened.\n");
+
+  if ((fread(&n, sizeof(int), 1, input) != 1) || (fread(&rows, sizeof(int), 1, input) != 1))
+    fatal("Invalid union-find checkpoint file");
+
+  if ((n != uf->numNodes) || (rows != rowsDone))
+    fatal("Union-find checkpoint file does not match checkpoint");
+
+  if (((int)fread(uf->parent, sizeof(int), n, input) != n) || ((int)fread(uf->rank, sizeof(char), n, input) != n))
+    fatal("Union-find checkpoint file is incomplete");
+  if (((int)fread(uf->size, sizeof(int), n, input) != n) || ((int)fread(uf->edges, sizeof(long int), n, input) != n))
+    fatal("Union-find checkpoint file is incomplete");
+
+  fclose(input);
+}
+
+
+int labelComponents(UnionFind *uf, int *clusterNum)
+{
+  int n = uf->numNodes;
+  int *rootNum; // cluster number of each root
+  int k = 0; // number of clusters (numbered in order of their first node)
+
+  if ((rootNum = new int[n]) == NULL)
+    fatal("memory not allocated");
+
+  for (int i = 0; i < n; i++)
+    rootNum[i] = -1;
+
+  for (int i = 0; i < n; i++) { // first node of each component names it
+    int root = findRoot(uf, i);
+
+    if (uf->size[root] == 1) // no edges, so node is a singleton
+      clusterNum[i] = -1;
+
+    else {
+      if (rootNum[root] == -1)
+	rootNum[root] = k++;
+      clusterNum[i] = rootNum[root];
+    }
+  }
+
+  delete [] rootNum;
+  return k;
+}
+
+
+void writeComponents(const char *fileName, UnionFind *uf, long int numEdges, FILE *logfile)
+{
+  FILE *output;
+  int n = uf->numNodes;
+  int *clusterNum; // cluster number of each node
+  int numSingle = 0; // count nodes with degree zero
+  int numTwo = 0; // count number of components with 2 vertices
+  int numComp3orMore = 0; // number of components with 3 or more vertices
+  int numNotCliques = 0; // number of components that aren't cliques
+  int maxCompAll = 0; // max size of component overall
+
+  if ((output = fopen(fileName, "w")) == NULL)
+    fatal("Components output file could not be opened.\n");
+
+  if ((clusterNum = new int[n]) == NULL)
+    fatal("memory not allocated");
+
+  int k = labelComponents(uf, clusterNum); // number of clusters
+
+  for (int i = 0; i < n; i++) { // each root describes its component
+    int root = findRoot(uf, i);
+    int ptr = uf->size[root]; // vertices in component
+
+    if (ptr == 1) { // no edges, so node is a singleton
+      numSingle++;
+      continue;
+    }
+
+    if (root != i)
+      continue; // component counted at its root
+
+    if (ptr > maxCompAll)
+      maxCompAll = ptr;
+
+    if (ptr == 2)
+      numTwo++;
+
+    else {
+      numComp3orMore++;
+
+      long double complete = (double)uf->edges[root]; // compute completeness of cluster
+      complete /= (long double)ptr * (long double)(ptr-1);
+      complete *= (double)(2.0);
+
+      if (complete < 0.99999) // not a clique
+	numNotCliques++;
+    }
+  }
+
+  fprintf(output, "%d nodes %d clusters %ld edges\n", n, k, numEdges);
+  for (int i = 0; i < n; i++)
+    fprintf(output, "%d ", clusterNum[i]);
+  fprintf(output, "\n\n");
+
+  fprintf(output, "%d singletons, %d components with only 2 vertices,\n%d components with 3 or more vertices\n", numSingle, numTwo, numComp3orMore);
+  fprintf(output, "%d vertices in largest component overall\n", maxCompAll);
+  fprintf(output, "%d components are not cliques\n", numNotCliques);
+  fclose(output);
+
+  cout << "\n" << k << " components with 2 or more vertices and " << numSingle << " singletons written to '" << fileName << "'." << endl;
+  cout << maxCompAll << " vertices in largest component, " << numNotCliques << " components are not cliques." << endl;
+
+  if(LOG_FILE) {
+    fprintf(logfile, "\n%d components with 2 or more vertices and %d singletons written to '%s'.\n", k, numSingle, fileName);
+    fprintf(logfile, "%d vertices in largest component, %d components are not cliques.\n", maxCompAll, numNotCliques);
+  }
+
+  delete [] clusterNum;
+}
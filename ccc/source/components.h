@@ -0,0 +1,44 @@
+// -------------------------------------------------------------------------
+// components.h -   Header file for finding blocs while ccc is running
+//
+// Each edge is passed to a union-find structure as it is printed, so the
+// connected components are known when the last pair is done and the
+// edge file never needs to be read back in.  Components are written in
+// the same format as the .bfs files written by bfs.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _COMPONENTS_H
+#define _COMPONENTS_H
+
+#include "bloc.h"
+
+struct UnionFind
+{
+  int numNodes; // number of nodes in graph (ids run from 1 to numNodes)
+  int *parent; // parent of each node, roots are their own parent
+  char *rank; // upper bound on height of tree below each root
+  int *size; // number of nodes in each root's component
+  long int *edges; // number of edges in each root's component
+};
+
+void allocUnionFind(UnionFind *uf, int numNodes); // each node on its own
+void freeUnionFind(UnionFind *uf);
+
+int findRoot(UnionFind *uf, int node); // node indexed from zero
+void unionEdge(UnionFind *uf, int source, int target); // node ids from one
+
+// save and restore state for checkpoints, rowsDone must match when loading
+void saveUnionFind(const char *fileName, const UnionFind *uf, int rowsDone);
+void loadUnionFind(const char *fileName, UnionFind *uf, int rowsDone);
+
+// find cluster number of each node, numbered in order of their first
+// node as bfs does (-1 for singletons), return number of clusters
+int labelComponents(UnionFind *uf, int *clusterNum);
+
+// write component of each node and summary in .bfs format
+void writeComponents(const char *fileName, UnionFind *uf, long int numEdges, FILE *logfile);
+
+#endif
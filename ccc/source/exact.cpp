@@ -0,0 +1,93 @@
+/****************************************************************************
+*
+*	exact.cpp:	Exact integer evaluation of CCC values.  Results
+*                       do not depend on the compiler or on the order of
+*                       floating point operations.
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include "exact.h"
+
+using namespace std;
+
+int parseThreshold(const char *strng, long int *num, long int *den)
+{
+  *num = 0;
+  *den = 1;
+  int digits = 0; // number of digits read
+  int point = 0; // set to 1 once decimal point is read
+
+  for (const char *c = strng; *c != '\0'; c++) {
+    if ((*c == '.') && !point) {
+      point = 1;
+      continue;
+    }
+
+    if ((*c < '0') || (*c > '9'))
+      return 0; // not a plain decimal value
+
+    if (point) {
+      if (*den >= 1000000000)
+	return 0; // too many decimal places
+      *den *= 10;
+    }
+
+    *num = *num * 10 + (*c - '0');
+    digits++;
+
+    if (*num > 1000000000)
+      return 0; // too large to be a sensible threshold
+  }
+
+  return (digits > 0);
+}
+
+
+void exactFreq(const SparseSnp *snp, ExactFreq *ef)
+{
+  long int have = snp->count[0] + snp->count[1] + snp->count[2]; // without missing data
+
+  if (!FREQ) { // frequency factors are all one
+    ef->num[0] = ef->num[1] = ef->den = (have > 0);
+    return;
+  }
+
+  long int low = 2 * snp->count[0] + snp->count[1]; // copies of low allele
+  long int high = 2 * snp->count[2] + snp->count[1]; // copies of high allele
+
+  // 1 - (copies / (2 * have)) / FREQWT, over a denominator of 2 * have * FREQWT_NUM
+  ef->den = 2 * have * FREQWT_NUM;
+  ef->num[0] = ef->den - low * FREQWT_DEN;
+  ef->num[1] = ef->den - high * FREQWT_DEN;
+}
+
+
+int exactValues(const int tally[4][4], const ExactFreq *ef1, const ExactFreq *ef2, uint128 val[4], uint128 *den)
+{
+  long int noMissing = 0; // individuals with no missing data for either SNP
+
+  for (int row = 0; row < 3; row++)
+    for (int col = 0; col < 3; col++)
+      noMissing += tally[row][col];
+
+  if ((noMissing == 0) || (ef1->den == 0) || (ef2->den == 0))
+    return 0;
+
+  // four times the weighted tallies of each relationship
+  long int ll = 4*tally[0][0] + 2*tally[0][1] + 2*tally[1][0] + tally[1][1];
+  long int lh = 2*tally[0][1] + 4*tally[0][2] + tally[1][1] + 2*tally[1][2];
+  long int hl = 2*tally[1][0] + tally[1][1] + 4*tally[2][0] + 2*tally[2][1];
+  long int hh = tally[1][1] + 2*tally[1][2] + 2*tally[2][1] + 4*tally[2][2];
+
+  val[0] = (uint128)ll * (uint128)ef1->num[0] * (uint128)ef2->num[0];
+  val[1] = (uint128)lh * (uint128)ef1->num[0] * (uint128)ef2->num[1];
+  val[2] = (uint128)hl * (uint128)ef1->num[1] * (uint128)ef2->num[0];
+  val[3] = (uint128)hh * (uint128)ef1->num[1] * (uint128)ef2->num[1];
+
+  *den = (uint128)noMissing * (uint128)ef1->den * (uint128)ef2->den;
+
+  return 1;
+}
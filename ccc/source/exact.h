@@ -0,0 +1,40 @@
+// -------------------------------------------------------------------------
+// exact.h -   Header file for exact integer evaluation of CCC values
+//
+// Tallies are scaled by 4 so the heterozygous weights (1/2 and 1/4)
+// become integers, and each frequency factor is kept as an integer
+// numerator over a denominator of 2 * FREQWT_NUM * (number of
+// individuals without missing data).  The four values for a pair then
+// share one denominator and the threshold test is a comparison of
+// cross-multiplied integers, with no division or rounding.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _EXACT_H
+#define _EXACT_H
+
+#include "bloc.h"
+#include "sparse.h"
+
+typedef unsigned __int128 uint128; // holds products of up to ~1e38
+
+struct ExactFreq
+{
+  long int num[2]; // frequency factor numerators for low and high alleles
+  long int den; // common denominator (0 if all genotypes are missing)
+};
+
+// convert a decimal threshold string to a fraction, return 0 if not decimal
+int parseThreshold(const char *strng, long int *num, long int *den);
+
+// find integer frequency factors from genotype counts of a SNP
+void exactFreq(const SparseSnp *snp, ExactFreq *ef);
+
+// find the numerators of the four values for a pair and the value of their
+// common denominator, return 0 if no individuals lack missing data
+//   CCC value of relationship r = 9 * val[r] / (8 * den)
+int exactValues(const int tally[4][4], const ExactFreq *ef1, const ExactFreq *ef2, uint128 val[4], uint128 *den);
+
+#endif
@@ -0,0 +1,344 @@
+/****************************************************************************
+*
+*	genotypes.cpp:	Reading genotype text and counting carriers of
+*                       clusters of alleles (see genotypes.h).
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#include "bloc.h"
+#include "genotypes.h"
+
+using namespace std;
+
+struct TextScan // position in a text buffer, read token by token
+{
+  const char *next; // next character to read
+  const char *end; // end of buffer
+  char strng[200]; // current token
+};
+
+
+static int nextToken(TextScan *scan) // read next token as fscanf("%s") does, 0 at end
+{
+  while ((scan->next < scan->end) && isspace((unsigned char)*scan->next))
+    scan->next++;
+
+  if (scan->next == scan->end)
+    return 0;
+
+  int len = 0; // length of token
+  while ((scan->next < scan->end) && !isspace((unsigned char)*scan->next)) {
+    if (len < 199)
+      scan->strng[len++] = *scan->next;
+    scan->next++;
+  }
+
+  scan->strng[len] = '\0';
+  return 1;
+}
+
+
+static int isMissing(int ascii) // 'N', '0', '?', 'X' or customized missing symbol
+{
+  return (ascii == 48) || (ascii == 78) || (ascii == 63) || (ascii == 88) || (ascii == MISSING_SYMBOL);
+}
+
+
+static int isAllele(int ascii) // 'A', 'C', 'G', 'T', 'I' or 'D'
+{
+  return (ascii == 65) || (ascii == 67) || (ascii == 71) || (ascii == 84) || (ascii == 73) || (ascii == 68);
+}
+
+
+// read the two alleles of the next genotype, return 0 if buffer ends
+static int readGenotype(TextScan *scan, int space, int slash, int *ascii1, int *ascii2)
+{
+  if (!nextToken(scan))
+    return 0;
+
+  *ascii1 = scan->strng[0];
+
+  if (space) { // second allele is next token
+    if (!nextToken(scan))
+      return 0;
+    *ascii2 = scan->strng[0];
+    return 1;
+  }
+
+  if (slash)
+    *ascii2 = scan->strng[2]; // second allele is third char, after '/'
+  else
+    *ascii2 = scan->strng[1]; // second allele is second char
+
+  if (isMissing(*ascii1))
+    *ascii2 = 78; // set to missing as might have 'NA' in input
+
+  return 1;
+}
+
+
+// skip header rows, return 0 if text ends first
+static int skipHeader(TextScan *scan, const GenotypeLayout *layout)
+{
+  int numInCols = layout->rowsAreSnps ? layout->numInd : layout->numSnps; // columns of data
+
+  for (long int i = 0; i < (long int)layout->numHeadRows * (layout->numHeadCols + numInCols); i++)
+    if (!nextToken(scan))
+      return 0;
+  return 1;
+}
+
+
+// find format from first genotype that isn't missing
+static int findFormat(const char *text, long int length, const GenotypeLayout *layout, int *space, int *slash, char *error)
+{
+  int numInRows = layout->rowsAreSnps ? layout->numSnps : layout->numInd; // rows of data
+  int numInCols = layout->rowsAreSnps ? layout->numInd : layout->numSnps; // columns of data
+  TextScan scan;
+
+  scan.next = text;
+  scan.end = text + length;
+  *space = *slash = 0;
+
+  if (!skipHeader(&scan, layout)) {
+    sprintf(error, "Input file is missing data");
+    return 0;
+  }
+
+  for (int i = 0; i < numInRows; i++)
+    for (int j = 0; j < layout->numHeadCols + numInCols; j++) {
+      if (!nextToken(&scan)) {
+	sprintf(error, "Input file is missing data");
+	return 0;
+      }
+
+      if ((j >= layout->numHeadCols) && !isMissing(scan.strng[0])) {
+	if ((int)scan.strng[1] == 47) // second char is a '/'
+	  *slash = 1;
+
+	else if ((int)scan.strng[1] < 65) // second char is not a letter
+	  *space = 1; // space between chars
+
+	return 1; // determined format
+      }
+    }
+
+  return 1; // all missing
+}
+
+
+// read every genotype, either adding to the alleles of each SNP (row and
+// record are NULL) or recording its code in row or passing it to record
+static int readText(const char *text, long int length, const GenotypeLayout *layout, char (*allele)[2], char **row, void (*record)(int, int, char, void*), void *arg, char *error)
+{
+  int numInRows = layout->rowsAreSnps ? layout->numSnps : layout->numInd; // rows of data
+  int numInCols = layout->rowsAreSnps ? layout->numInd : layout->numSnps; // columns of data
+  int space, slash; // set to 1 if space or slash mark between alleles
+  int ascii1, ascii2; // alleles of current genotype
+  TextScan scan;
+
+  if (!findFormat(text, length, layout, &space, &slash, error))
+    return 0;
+
+  scan.next = text;
+  scan.end = text + length;
+  skipHeader(&scan, layout);
+
+  for (int i = 0; i < numInRows; i++) {
+    for (int j = 0; j < layout->numHeadCols; j++)
+      if (!nextToken(&scan)) { // disregard header columns
+	sprintf(error, "Input file is missing data");
+	return 0;
+      }
+
+    for (int j = 0; j < numInCols; j++) {
+      if (!readGenotype(&scan, space, slash, &ascii1, &ascii2)) {
+	sprintf(error, "Input file is missing data");
+	return 0;
+      }
+
+      int snp = layout->rowsAreSnps ? i : j; // current SNP
+      int ind = layout->rowsAreSnps ? j : i; // current individual
+
+      if ((!isAllele(ascii1) && !isMissing(ascii1)) || (!isAllele(ascii2) && !isMissing(ascii2))) {
+	sprintf(error, "Improper input data for SNP %d of individual %d: %c%c", snp+1, ind+1, (char)ascii1, (char)ascii2);
+	return 0;
+      }
+
+      if ((row == NULL) && (record == NULL)) { // find alleles
+	if (isMissing(ascii1))
+	  continue;
+
+	if (allele[snp][0] == '0') // haven't found first allele yet
+	  allele[snp][0] = (char)ascii1;
+	else if ((allele[snp][1] == '0') && (ascii1 != allele[snp][0]))
+	  allele[snp][1] = (char)ascii1; // found second allele
+
+	if ((allele[snp][1] == '0') && (ascii2 != allele[snp][0]))
+	  allele[snp][1] = (char)ascii2; // found second allele
+	continue;
+      }
+
+      if ((!isMissing(ascii1) && (ascii1 != allele[snp][0]) && (ascii1 != allele[snp][1])) || (!isMissing(ascii2) && (ascii2 != allele[snp][0]) && (ascii2 != allele[snp][1]))) {
+	sprintf(error, "SNP %d for individual %d (%c%c) doesn't match: %c%c.  Are there more than 2 alleles?", snp+1, ind+1, allele[snp][0], allele[snp][1], (char)ascii1, (char)ascii2);
+	return 0;
+      }
+
+      if ((row != NULL) && (row[snp] == NULL))
+	continue; // SNP not wanted
+
+      char code; // copies of highest allele, 3 if missing
+      if (isMissing(ascii1))
+	code = 3;
+      else if (ascii1 != ascii2) // heterozygous
+	code = 1;
+      else if (ascii1 == allele[snp][0]) // homozygote in first allele
+	code = 0;
+      else // homozygote in second allele
+	code = 2;
+
+      if (row != NULL)
+	row[snp][ind] = code;
+      else
+	record(snp, ind, code, arg);
+    }
+  }
+
+  if (nextToken(&scan)) {
+    sprintf(error, "Unread data in input file");
+    return 0;
+  }
+
+  return 1;
+}
+
+
+int mapText(const char *fileName, GenotypeText *text)
+{
+  int fd; // file descriptor
+  struct stat st; // size of file
+
+  text->data = NULL;
+  text->size = 0;
+
+  if ((fd = open(fileName, O_RDONLY)) < 0)
+    return 0;
+
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return 0;
+  }
+
+  text->size = st.st_size;
+  if (text->size > 0) {
+    text->data = (char *)mmap(NULL, text->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (text->data == MAP_FAILED) {
+      close(fd);
+      text->data = NULL;
+      return 0;
+    }
+  }
+
+  close(fd);
+  return 1;
+}
+
+
+void unmapText(GenotypeText *text)
+{
+  if (text->data != NULL)
+    munmap(text->data, text->size);
+  text->data = NULL;
+  text->size = 0;
+}
+
+
+int findAlleles(const char *text, long int length, const GenotypeLayout *layout, char (*allele)[2], char *error)
+{
+  return readText(text, length, layout, allele, NULL, NULL, NULL, error);
+}
+
+
+void sortAlleles(char (*allele)[2], int numSnps)
+{
+  for (int i = 0; i < numSnps; i++)
+    if (allele[i][0] > allele[i][1]) {
+      char temp = allele[i][0];
+      allele[i][0] = allele[i][1];
+      allele[i][1] = temp;
+    }
+}
+
+
+int encodeGenotypes(const char *text, long int length, const GenotypeLayout *layout, char (*allele)[2], char **row, char *error)
+{
+  return readText(text, length, layout, allele, row, NULL, NULL, error);
+}
+
+
+int scanGenotypes(const char *text, long int length, const GenotypeLayout *layout, char (*allele)[2], void (*record)(int, int, char, void*), void *arg, char *error)
+{
+  return readText(text, length, layout, allele, NULL, record, arg, error);
+}
+
+
+int alleleFreq(const char *codes, int numInd, double *freq)
+{
+  int count[4] = {0, 0, 0, 0}; // individuals with each code
+
+  for (int k = 0; k < numInd; k++)
+    count[(int)codes[k]]++;
+
+  countFreq(count, numInd, freq);
+  return count[3];
+}
+
+
+void countFreq(const int *count, int numInd, double *freq)
+{
+  int haveGenotype = numInd - count[3]; // individuals without missing data
+  freq[0] = 2 * count[0] + count[1]; // copies of each allele
+  freq[1] = 2 * count[2] + count[1];
+
+  for (int j = 0; j < 2; j++)
+    freq[j] /= 2 * haveGenotype; // divide by 2*number without missing
+}
+
+
+void countCarriers(char **row, int numSnps, int firstInd, int numInd, const int *first, const int *members, int numClusters, int *carriers, int *noMissing)
+{
+  for (int c = 0; c < numClusters; c++) {
+    carriers[c] = 0;
+    noMissing[c] = 0;
+  }
+
+  for (int ind = firstInd; ind < firstInd + numInd; ind++)
+    for (int c = 0; c < numClusters; c++) {
+      int carrier = 1; // set to 0 if individual lacks an allele of cluster
+      int missing = 0; // set to 1 if a genotype of cluster is missing
+
+      for (int k = first[c]; k < first[c+1]; k++) {
+	int node = members[k]; // allele node (from zero)
+	int high = (node >= numSnps); // 1 for highest allele of SNP
+	int code = row[node - high * numSnps][ind]; // copies of highest allele
+
+	if (code == 3) {
+	  missing = 1;
+	  carrier = 0;
+	}
+
+	else if ((high && (code == 0)) || (!high && (code == 2)))
+	  carrier = 0; // no copies of this allele
+      }
+
+      carriers[c] += carrier;
+      noMissing[c] += !missing;
+    }
+}
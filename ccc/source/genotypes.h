@@ -0,0 +1,72 @@
+// -------------------------------------------------------------------------
+// genotypes.h -   Header file for reading genotype text and counting
+//                 carriers of clusters of alleles
+//
+// Genotypes are read from text in memory in the formats accepted by ccc
+// (see README_ccc): two alleles per genotype, written together ("AG"),
+// with a slash ("A/G") or as two tokens ("A G"), with 'N', '0', '?',
+// 'X' or MISSING_SYMBOL (set in 'bloc.h') for missing data.  The format
+// is found from the first genotype that isn't missing.  Each genotype is
+// coded as the number of copies of the allele that is highest
+// alphabetically, or 3 if missing.
+//
+// ccc, carriers and libblocbuster all read genotypes and count carriers
+// with these functions.  This header doesn't include 'bloc.h', so that
+// carriers can use it alongside its own constants.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _GENOTYPES_H
+#define _GENOTYPES_H
+
+struct GenotypeText // genotype input file mapped into memory
+{
+  char *data; // contents of file (NULL if empty)
+  long int size; // bytes in data
+};
+
+struct GenotypeLayout // shape of a genotype text
+{
+  int numInd; // number of individuals
+  int numSnps; // number of SNPs
+  int numHeadRows; // header rows to skip
+  int numHeadCols; // header columns to skip at the start of each row
+  int rowsAreSnps; // 1 if each row is a SNP, 0 if each row is an individual
+};
+
+int mapText(const char *fileName, GenotypeText *text); // map file, return 0 if it can't be opened
+void unmapText(GenotypeText *text); // release mapping
+
+// add the alleles found in text to allele ('0' where none found yet),
+// in the order they appear; return 1 if successful, or 0 with the
+// reason in error (at least 200 chars)
+int findAlleles(const char *text, long int length, const GenotypeLayout *layout, char (*allele)[2], char *error);
+
+void sortAlleles(char (*allele)[2], int numSnps); // alphabetical order within each SNP
+
+// record the code of each genotype of SNP s in row[s] (not recorded if
+// row[s] is NULL), given the sorted alleles; return 1 if successful, or
+// 0 with the reason in error
+int encodeGenotypes(const char *text, long int length, const GenotypeLayout *layout, char (*allele)[2], char **row, char *error);
+
+// as above, but pass each code to record(snp, individual, code, arg)
+// instead of storing it, in the order the genotypes are read
+int scanGenotypes(const char *text, long int length, const GenotypeLayout *layout, char (*allele)[2], void (*record)(int, int, char, void*), void *arg, char *error);
+
+// set freq to the frequencies of the lowest and highest alleles among
+// the individuals with genotypes, return number with missing genotypes
+int alleleFreq(const char *codes, int numInd, double *freq);
+
+// as above, given the number of individuals with each code
+void countFreq(const int *count, int numInd, double *freq);
+
+// for individuals firstInd to firstInd + numInd - 1, count those with
+// every allele of each cluster and those with no missing genotypes for
+// the cluster.  Cluster c holds allele nodes members[first[c]] to
+// members[first[c+1] - 1], where node s (from zero) is the lowest
+// allele of SNP s and node s + numSnps the highest.
+void countCarriers(char **row, int numSnps, int firstInd, int numInd, const int *first, const int *members, int numClusters, int *carriers, int *noMissing);
+
+#endif
@@ -0,0 +1,181 @@
+/****************************************************************************
+*
+*	groups.cpp:	CCC values for several groups of individuals,
+*                       found in a single sweep over the pairs of SNPs.
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include "groups.h"
+#include "tile.h"
+
+using namespace std;
+
+void readGroups(const char *fileName, int numInd, GroupMap *map)
+{
+  FILE *input;
+  char strng[200]; // temporary string storage
+
+  if ((input = fopen(fileName, "r")) == NULL)
+    fatal("Group mapping file could not be opened.\n");
+
+  if ((map->group = new char[numInd]) == NULL)
+    fatal("memory not allocated");
+
+  map->numGroups = 0;
+
+  for (int k = 0; k < numInd; k++) {
+    if (fscanf(input, "%199s", strng) != 1)
+      fatal("Group mapping file has fewer labels than individuals");
+
+    if (strlen(strng) > 49)
+      fatal("Group label in mapping file is longer than 49 characters");
+
+    int g; // index of this label
+    for (g = 0; g < map->numGroups; g++)
+      if (strcmp(strng, map->label[g]) == 0)
+	break;
+
+    if (g == map->numGroups) { // new label
+      if (map->numGroups == MAX_NUM_GROUPS)
+	fatal("Too many groups in mapping file. Check MAX_NUM_GROUPS in bloc.h");
+      strcpy(map->label[g], strng);
+      map->size[g] = 0;
+      map->numGroups++;
+    }
+
+    map->group[k] = g;
+    map->size[g]++;
+  }
+
+  if (fscanf(input, "%199s", strng) == 1)
+    fatal("Group mapping file has more labels than individuals");
+
+  fclose(input);
+}
+
+
+void groupFreqs(char **data, int numSnps, int numInd, const GroupMap *map, FreqVec *freq)
+{
+  for (int g = 0; g < map->numGroups; g++)
+    for (int j = 0; j < 2; j++)
+      freq[g].f[j] = (double*)alignedAlloc(numSnps * sizeof(double));
+
+  for (int i = 0; i < numSnps; i++) {
+    int count[MAX_NUM_GROUPS][4]; // number of each genotype code in each group
+
+    for (int g = 0; g < map->numGroups; g++)
+      for (int c = 0; c < 4; c++)
+	count[g][c] = 0;
+
+    for (int k = 0; k < numInd; k++)
+      count[map->group[k]][data[i][k]]++;
+
+    for (int g = 0; g < map->numGroups; g++) {
+      int have = count[g][0] + count[g][1] + count[g][2]; // without missing data
+
+      if (have == 0) { // all missing, so there are no relationships
+	freq[g].f[0][i] = freq[g].f[1][i] = 1.0;
+	continue;
+      }
+
+      // same steps as for the full set of individuals
+      freq[g].f[0][i] = (double)(2 * count[g][0] + count[g][1]) / (2 * have);
+      freq[g].f[1][i] = (double)(2 * count[g][2] + count[g][1]) / (2 * have);
+
+      for (int j = 0; j < 2; j++)
+	freq[g].f[j][i] = 1 - (freq[g].f[j][i] / FREQWT);
+    }
+  }
+}
+
+
+long int sweepGroups(char **data1, int numSnps1, int start1, const FreqVec *freq1, char **data2, int numSnps2, int start2, const FreqVec *freq2, int numInd, int numSnps, const GroupMap *map, float thresh, FILE **output, long int *numEdges, float *maxBloc, const long int *rowPairs, Progress *prog, FILE *logfile)
+{
+  int numGroups = map->numGroups;
+  long int totalEdges = 0; // edges printed for all groups
+  long int pairsDone = 0; // pairs in completed rows
+  PairTile tile[MAX_NUM_GROUPS]; // tile of pairs for each group
+  int (*count)[4][4]; // tallies of each group for one pair
+
+  if ((count = new int[numGroups][4][4]) == NULL)
+    fatal("memory not allocated");
+
+  for (int g = 0; g < numGroups; g++) {
+    allocTile(&tile[g]);
+    numEdges[g] = 0;
+    maxBloc[g] = 0.0;
+  }
+
+  for (int i = 0; i < numSnps1; i++) {
+    int firstJ = start1 + i - start2 + 1; // upper diagonal only
+    if (firstJ < 0)
+      firstJ = 0;
+
+    for (int tileStart = firstJ; tileStart < numSnps2; tileStart += PAIR_BLOCK) {
+      int tileSize = numSnps2 - tileStart; // number of pairs in this tile
+      if (tileSize > PAIR_BLOCK)
+	tileSize = PAIR_BLOCK;
+
+      for (int b = 0; b < tileSize; b++) { // tally each pair for all groups at once
+	int j = tileStart + b;
+	const char *row1 = data1[i];
+	const char *row2 = data2[j];
+
+	memset(count, 0, numGroups * sizeof(*count));
+
+	for (int k = 0; k < numInd; k++)
+	  count[map->group[k]][row1[k]][row2[k]]++;
+
+	for (int g = 0; g < numGroups; g++)
+	  setTally(&tile[g], b, count[g]);
+      }
+
+      for (int g = 0; g < numGroups; g++) {
+	tileProducts(&tile[g], tileSize, &freq1[g], i, &freq2[g], tileStart);
+	finaliseTile(&tile[g], tileSize);
+
+	for (int b = 0; b < tileSize; b++) { // check and print out each pair
+	  int j = tileStart + b;
+
+	  if (tile[g].max[b] > maxBloc[g])
+	    maxBloc[g] = tile[g].max[b];
+
+	  // endpoints of the ll, lh, hl and hh edges
+	  int source[4] = {start1+i+1, start1+i+1, start1+i+numSnps+1, start1+i+numSnps+1};
+	  int target[4] = {start2+j+1, start2+j+numSnps+1, start2+j+1, start2+j+numSnps+1};
+
+	  for (int r = 0; r < 4; r++) {
+	    float value = TWONODE ? tile[g].value[r][b] : tile[g].max[b];
+
+	    if (value > thresh - TOL) {
+	      if (fprintf(output[g], "\tedge\n\t[\n\tsource %d\n\ttarget %d\n\tweight %f\n\t]\n", source[r], target[r], (float)(value * 4.5)) < 0)
+		fatal("Output file could not be written.\n");
+	      numEdges[g]++;
+	      totalEdges++;
+	    }
+
+	    if (!TWONODE)
+	      break; // just one possible edge
+	  }
+
+	  if (numEdges[g] > MAX_NUM_EDGES)
+	    fatal("Too many edges printed out. Check MAX_NUM_EDGES in header file.");
+	}
+      }
+    }
+
+    pairsDone += rowPairs[i];
+    updateProgress(prog, pairsDone, totalEdges, 0, logfile); // group files aren't counted
+  }
+
+  for (int g = 0; g < numGroups; g++) {
+    freeTile(&tile[g]);
+    maxBloc[g] *= 4.5;
+  }
+  delete [] count;
+
+  return totalEdges;
+}
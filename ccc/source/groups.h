@@ -0,0 +1,42 @@
+// -------------------------------------------------------------------------
+// groups.h -   Header file for stratified CCC values in one sweep
+//
+// Individuals are assigned to groups (cases, controls, ancestry groups,
+// etc.) by a mapping file.  For each pair of SNPs, the genotype
+// combinations of every group are tallied in the same pass over the
+// individuals, and each group's values are found with that group's own
+// frequency factors.  Edges for each group are printed to a separate
+// .gml file.  Alleles are oriented and nodes numbered once, from all
+// the individuals, so a SNP that is monomorphic within a group may have
+// its alleles and node ids swapped relative to a separate ccc run on
+// that group's individuals.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _GROUPS_H
+#define _GROUPS_H
+
+#include "bloc.h"
+#include "progress.h"
+
+struct GroupMap
+{
+  int numGroups; // number of distinct labels in mapping file
+  char label[MAX_NUM_GROUPS][50]; // label of each group
+  int size[MAX_NUM_GROUPS]; // number of individuals in each group
+  char *group; // group index of each individual
+};
+
+// read one label per individual, in the order of the genotype input file
+void readGroups(const char *fileName, int numInd, GroupMap *map);
+
+// find frequency factors of each group for a set of dense SNP rows
+void groupFreqs(char **data, int numSnps, int numInd, const GroupMap *map, FreqVec *freq);
+
+// evaluate all pairs and print edges of group g to output[g], return
+// total number of edges printed
+long int sweepGroups(char **data1, int numSnps1, int start1, const FreqVec *freq1, char **data2, int numSnps2, int start2, const FreqVec *freq2, int numInd, int numSnps, const GroupMap *map, float thresh, FILE **output, long int *numEdges, float *maxBloc, const long int *rowPairs, Progress *prog, FILE *logfile);
+
+#endif
@@ -0,0 +1,147 @@
+/****************************************************************************
+*
+*	permute.cpp:	Permutation replicates for finding the null
+*                       distribution of CCC values without rereading
+*                       the genotype data.
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include "permute.h"
+#include "tile.h"
+
+using namespace std;
+
+static unsigned long int splitMix(unsigned long int *state) // next random value
+{
+  unsigned long int z = (*state += 0x9e3779b97f4a7c15UL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9UL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebUL;
+  return z ^ (z >> 31);
+}
+
+
+void shuffleRow(char *row, int numInd, unsigned long int seed, int replicate, int snpIndex)
+{
+  unsigned long int state = seed; // generator for this SNP and replicate
+  unsigned long int mix = splitMix(&state) + (unsigned long int)replicate;
+  state = mix;
+  mix = splitMix(&state) + (unsigned long int)snpIndex;
+  state = mix;
+
+  for (int k = numInd - 1; k > 0; k--) { // Fisher-Yates shuffle
+    int swap = (int)(splitMix(&state) % (unsigned long int)(k+1));
+    char temp = row[k];
+    row[k] = row[swap];
+    row[swap] = temp;
+  }
+}
+
+
+// shuffled copy of a set of SNPs, stored as the real data is
+static void permuteSet(const SnpSet *set, SnpSet *perm, int numInd, float maxFrac, unsigned long int seed, int replicate)
+{
+  perm->numSnps = set->numSnps;
+  perm->start = set->start;
+  perm->freq = set->freq; // genotype counts are unchanged
+
+  if (((perm->data = new char* [set->numSnps]) == NULL) || ((perm->snp = new SparseSnp[set->numSnps]) == NULL))
+    fatal("memory not allocated");
+
+  for (int i = 0; i < set->numSnps; i++) {
+    if ((perm->data[i] = new char[numInd]) == NULL)
+      fatal("memory not allocated");
+
+    expandSnp(&set->snp[i], set->data[i], numInd, perm->data[i]);
+    shuffleRow(perm->data[i], numInd, seed, replicate, set->start + i);
+
+    if (makeSparse(perm->data[i], numInd, maxFrac, &perm->snp[i])) {
+      delete [] perm->data[i]; // dense row no longer needed
+      perm->data[i] = NULL;
+    }
+  }
+}
+
+
+static void freeSet(SnpSet *perm)
+{
+  for (int i = 0; i < perm->numSnps; i++) {
+    if (perm->data[i] != NULL)
+      delete [] perm->data[i];
+    freeSparse(&perm->snp[i]);
+  }
+
+  delete [] perm->data;
+  delete [] perm->snp;
+}
+
+
+// find maximum value and count edges for all pairs of one replicate
+static void sweepPairs(const SnpSet *set1, const SnpSet *set2, int numInd, float thresh, PairTile *tile, PermResult *result)
+{
+  float maxBloc = 0.0; // unscaled maximum
+  long int numEdges = 0;
+
+  for (int i = 0; i < set1->numSnps; i++) {
+    int firstJ = set1->start + i - set2->start + 1; // upper diagonal only
+    if (firstJ < 0)
+      firstJ = 0;
+
+    for (int tileStart = firstJ; tileStart < set2->numSnps; tileStart += PAIR_BLOCK) {
+      int tileSize = set2->numSnps - tileStart; // number of pairs in this tile
+      if (tileSize > PAIR_BLOCK)
+	tileSize = PAIR_BLOCK;
+
+      for (int b = 0; b < tileSize; b++) { // tally each pair in tile
+	int j = tileStart + b;
+	int count[4][4]; // number of individuals with each relationship
+
+	pairTally(count, &set1->snp[i], set1->data[i], &set2->snp[j], set2->data[j], numInd);
+	setTally(tile, b, count);
+      }
+
+      tileProducts(tile, tileSize, set1->freq, i, set2->freq, tileStart);
+      finaliseTile(tile, tileSize);
+
+      for (int b = 0; b < tileSize; b++) { // same tests as for printing edges
+	if (tile->max[b] > maxBloc)
+	  maxBloc = tile->max[b];
+
+	if (!TWONODE) {
+	  if (tile->max[b] > thresh - TOL)
+	    numEdges++;
+	}
+
+	else
+	  for (int r = 0; r < 4; r++)
+	    if (tile->value[r][b] > thresh - TOL)
+	      numEdges++;
+      }
+    }
+  }
+
+  result->maxBloc = maxBloc * 4.5;
+  result->numEdges = numEdges;
+}
+
+
+void runPermutations(const SnpSet *set1, const SnpSet *set2, int numInd, float thresh, float maxFrac, int numPerms, unsigned long int seed, PermResult *result)
+{
+  #pragma omp parallel for schedule(dynamic)
+  for (int p = 0; p < numPerms; p++) { // each replicate is independent
+    SnpSet perm1, perm2; // shuffled copies of the two sets
+    PairTile tile; // arrays for a tile of pairs
+
+    permuteSet(set1, &perm1, numInd, maxFrac, seed, p);
+    permuteSet(set2, &perm2, numInd, maxFrac, seed, p);
+    allocTile(&tile);
+
+    sweepPairs(&perm1, &perm2, numInd, thresh, &tile, &result[p]);
+
+    freeTile(&tile);
+    freeSet(&perm1);
+    freeSet(&perm2);
+  }
+}
@@ -0,0 +1,35 @@
+// -------------------------------------------------------------------------
+// permute.h -   Header file for permutation replicates within ccc
+//
+// The genotypes of each SNP are shuffled among the individuals, as perm
+// does, but in memory and without writing or parsing text.  Shuffling
+// leaves the genotype counts of every SNP unchanged, so the frequency
+// factors of the real data are used for every replicate.  Each SNP is
+// shuffled with a generator seeded by the run seed, the replicate and
+// the SNP's index in the input file, so a SNP that is in both sets gets
+// the same shuffle in each, and results don't depend on the number of
+// threads.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _PERMUTE_H
+#define _PERMUTE_H
+
+#include "bloc.h"
+#include "sparse.h"
+
+struct PermResult
+{
+  float maxBloc; // maximum CCC value over all pairs (scaled)
+  long int numEdges; // number of edges that would have been printed
+};
+
+// shuffle a row of genotype codes in place
+void shuffleRow(char *row, int numInd, unsigned long int seed, int replicate, int snpIndex);
+
+// run numPerms replicates in parallel and store the null results
+void runPermutations(const SnpSet *set1, const SnpSet *set2, int numInd, float thresh, float maxFrac, int numPerms, unsigned long int seed, PermResult *result);
+
+#endif
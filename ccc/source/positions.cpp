@@ -0,0 +1,184 @@
+/****************************************************************************
+*
+*	positions.cpp:	SNP position index for evaluating only the pairs
+*                       of SNPs within a physical window, or only those
+*                       on different chromosomes.
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include "positions.h"
+
+using namespace std;
+
+struct PositionOrder // compare SNPs by chromosome, then position
+{
+  const int *chrom;
+  const long int *pos;
+
+  bool operator()(int a, int b) const {
+    if (chrom[a] != chrom[b])
+      return chrom[a] < chrom[b];
+    if (pos[a] != pos[b])
+      return pos[a] < pos[b];
+    return a < b;
+  }
+};
+
+
+void readPositions(const char *fileName, int numCols, int numHeadRows, int numSnps, SnpIndex *index)
+{
+  FILE *input;
+  char strng[200]; // temporary string storage
+  char chromName[200]; // chromosome of current SNP
+  char lastName[200]; // chromosome of previous SNP
+  char (*names)[50]; // names of chromosomes found so far
+  int numChroms = 0; // number of distinct chromosomes
+  int maxChroms = 100; // size of names array
+
+  if ((POS_CHROM_COL < 1) || (POS_CHROM_COL > numCols) || (POS_BP_COL < 1) || (POS_BP_COL > numCols))
+    fatal("POS_CHROM_COL and POS_BP_COL in bloc.h must be columns of the SNP info file");
+
+  if ((input = fopen(fileName, "r")) == NULL)
+    fatal("SNP info file could not be opened.\n");
+
+  index->numSnps = numSnps;
+  index->order = NULL;
+
+  if (((index->chrom = new int[numSnps]) == NULL) || ((index->pos = new long int[numSnps]) == NULL))
+    fatal("memory not allocated");
+  if ((names = new char[maxChroms][50]) == NULL)
+    fatal("memory not allocated");
+
+  for (int i = 0; i < numHeadRows * numCols; i++) // skip header rows
+    if (fscanf(input, "%199s", strng) != 1)
+      fatal("Missing header values in SNP info file");
+
+  lastName[0] = '\0';
+  int lastChrom = -1; // number of previous SNP's chromosome
+
+  for (int i = 0; i < numSnps; i++) {
+    for (int col = 1; col <= numCols; col++) {
+      if (fscanf(input, "%199s", strng) != 1)
+	fatal("Missing values in SNP info file");
+
+      if (col == POS_CHROM_COL)
+	strcpy(chromName, strng);
+
+      if (col == POS_BP_COL) {
+	char *end; // check that whole string is a number
+	index->pos[i] = strtol(strng, &end, 10);
+	if ((*end != '\0') || (index->pos[i] < 0))
+	  fatal("Invalid base pair position in SNP info file");
+      }
+    }
+
+    if (strlen(chromName) > 49)
+      fatal("Chromosome name in SNP info file is longer than 49 characters");
+
+    if (strcmp(chromName, lastName) != 0) { // SNPs are usually grouped by chromosome
+      int c;
+      for (c = 0; c < numChroms; c++)
+	if (strcmp(chromName, names[c]) == 0)
+	  break;
+
+      if (c == numChroms) { // new chromosome
+	if (numChroms == maxChroms) { // double size of names array
+	  char (*temp)[50];
+	  if ((temp = new char[2 * maxChroms][50]) == NULL)
+	    fatal("memory not allocated");
+	  memcpy(temp, names, maxChroms * sizeof(*names));
+	  delete [] names;
+	  names = temp;
+	  maxChroms *= 2;
+	}
+
+	strcpy(names[c], chromName);
+	numChroms++;
+      }
+
+      lastChrom = c;
+      strcpy(lastName, chromName);
+    }
+
+    index->chrom[i] = lastChrom;
+  }
+
+  if (fscanf(input, "%199s", strng) == 1)
+    fatal("Unread information in SNP info file");
+
+  fclose(input);
+  delete [] names;
+
+  cout << "Positions of " << numSnps << " SNPs on " << numChroms << " chromosomes read from '" << fileName << "'." << endl;
+}
+
+
+void buildIndex(SnpIndex *index, int start2, int numSnps2, long int window)
+{
+  index->start2 = start2;
+  index->numSnps2 = numSnps2;
+  index->window = window;
+
+  if ((index->order = new int[numSnps2]) == NULL)
+    fatal("memory not allocated");
+
+  for (int j = 0; j < numSnps2; j++)
+    index->order[j] = start2 + j; // index in input file
+
+  PositionOrder compare = {index->chrom, index->pos};
+  sort(index->order, index->order + numSnps2, compare);
+}
+
+
+int windowPairs(const SnpIndex *index, int snp, int firstJ, int *list)
+{
+  int num = 0; // number of SNPs listed
+  int chrom = index->chrom[snp];
+
+  if (index->window < 0) { // only SNPs on other chromosomes
+    for (int j = firstJ; j < index->numSnps2; j++)
+      if (index->chrom[index->start2 + j] != chrom)
+	list[num++] = j;
+    return num;
+  }
+
+  // binary search for first SNP at or after position - window
+  long int low = index->pos[snp] - index->window;
+  long int high = index->pos[snp] + index->window;
+  int left = 0;
+  int right = index->numSnps2;
+
+  while (left < right) {
+    int mid = (left + right) / 2;
+    int s = index->order[mid];
+    if ((index->chrom[s] < chrom) || ((index->chrom[s] == chrom) && (index->pos[s] < low)))
+      left = mid + 1;
+    else
+      right = mid;
+  }
+
+  for (int k = left; k < index->numSnps2; k++) {
+    int s = index->order[k];
+    if ((index->chrom[s] != chrom) || (index->pos[s] > high))
+      break; // past end of window
+
+    int j = s - index->start2; // index in second set
+    if (j >= firstJ) // upper diagonal only
+      list[num++] = j;
+  }
+
+  sort(list, list + num); // same order as without a window
+  return num;
+}
+
+
+void freeIndex(SnpIndex *index)
+{
+  delete [] index->chrom;
+  delete [] index->pos;
+  if (index->order != NULL)
+    delete [] index->order;
+}
@@ -0,0 +1,44 @@
+// -------------------------------------------------------------------------
+// positions.h -   Header file for restricting ccc to pairs of SNPs by
+//                 physical position
+//
+// Chromosomes and base pair positions are read from a SNP info file,
+// such as the one given to carriers.  The SNPs of the second set are
+// sorted by chromosome and position, so the SNPs within a window of a
+// given SNP are found by binary search, and only those pairs are
+// evaluated.  Alternatively, only pairs on different chromosomes are
+// evaluated.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _POSITIONS_H
+#define _POSITIONS_H
+
+#include "bloc.h"
+
+struct SnpIndex
+{
+  int numSnps; // number of SNPs in input file
+  int *chrom; // chromosome number of each SNP (in order of appearance)
+  long int *pos; // base pair position of each SNP
+  int start2; // index of first SNP of second set in input file
+  int numSnps2; // number of SNPs in second set
+  int *order; // SNPs of second set sorted by chromosome and position
+  long int window; // max distance in base pairs (-1 for cross-chromosome pairs)
+};
+
+// read POS_CHROM_COL and POS_BP_COL from each row of a SNP info file
+void readPositions(const char *fileName, int numCols, int numHeadRows, int numSnps, SnpIndex *index);
+
+// sort second set of SNPs by position for finding windows
+void buildIndex(SnpIndex *index, int start2, int numSnps2, long int window);
+
+// list SNPs of second set (from firstJ on) paired with SNP snp of the
+// input file in increasing order, return number listed
+int windowPairs(const SnpIndex *index, int snp, int firstJ, int *list);
+
+void freeIndex(SnpIndex *index);
+
+#endif
@@ -0,0 +1,448 @@
+/****************************************************************************
+*
+*	prefilter.cpp:	Candidate pairs of SNPs from min-hash signatures
+*                       of carrier sets or from estimates on a subsample
+*                       of individuals, and an audit of the recall of
+*                       candidate pairs.
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include "prefilter.h"
+
+using namespace std;
+
+static unsigned long int mix(unsigned long int z) // scramble bits of z
+{
+  z += 0x9e3779b97f4a7c15UL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9UL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebUL;
+  return z ^ (z >> 31);
+}
+
+
+static bool lessHash(const BandEntry &a, const BandEntry &b) // order of buckets
+{
+  return (a.hash < b.hash) || ((a.hash == b.hash) && ((a.snp < b.snp) || ((a.snp == b.snp) && (a.allele < b.allele))));
+}
+
+
+// find what bounds the values of each allele of set
+static void findBounds(AlleleBound *bd, const SnpSet *set, int numInd)
+{
+  if (((bd->mass = new float[2 * (long int)set->numSnps]) == NULL) || ((bd->factor = new float[2 * (long int)set->numSnps]) == NULL))
+    fatal("memory not allocated");
+  if (((bd->common = new char[2 * (long int)set->numSnps]) == NULL) || ((bd->missing = new int[set->numSnps]) == NULL))
+    fatal("memory not allocated");
+
+  bd->maxFactor = 0;
+  bd->maxMissing = 0;
+
+  for (int j = 0; j < set->numSnps; j++) {
+    const int *count = set->snp[j].count; // individuals with each genotype code
+    int haveGenotype = numInd - count[3]; // individuals without missing data
+    int carriers[2] = {count[0] + count[1], count[1] + count[2]}; // carriers of each allele
+
+    bd->mass[2*j] = count[0] + 0.5 * count[1];
+    bd->mass[2*j+1] = count[2] + 0.5 * count[1];
+    bd->missing[j] = count[3];
+
+    for (int a = 0; a < 2; a++) {
+      bd->factor[2*j+a] = FREQ ? set->freq->f[a][j] : 1.0;
+      bd->common[2*j+a] = (carriers[a] >= MINHASH_CARRIERS * haveGenotype);
+
+      if (bd->factor[2*j+a] > bd->maxFactor)
+	bd->maxFactor = bd->factor[2*j+a];
+    }
+
+    if (count[3] > bd->maxMissing)
+      bd->maxMissing = count[3];
+  }
+}
+
+
+static void freeBounds(AlleleBound *bd)
+{
+  delete [] bd->mass;
+  delete [] bd->factor;
+  delete [] bd->common;
+  delete [] bd->missing;
+}
+
+
+// largest value allele a of SNP i of first set can have with allele b of
+// SNP j of second set: the smaller of their halved copies over the fewest
+// individuals without missing data, times both factors
+static inline float pairBound(const MinHash *mh, int i, int a, int j, int b)
+{
+  const AlleleBound *bd1 = &mh->bound1;
+  const AlleleBound *bd2 = &mh->bound2;
+  int n = mh->numInd - bd1->missing[i] - bd2->missing[j]; // fewest individuals without missing data
+  float m1 = bd1->mass[2*i+a];
+  float m2 = bd2->mass[2*j+b];
+  float frac = ((m1 < m2) ? m1 : m2) / ((n > 1) ? n : 1); // at most the weighted tally over n
+
+  if (frac > 1)
+    frac = 1;
+
+  return frac * bd1->factor[2*i+a] * bd2->factor[2*j+b];
+}
+
+
+// find band hashes of both alleles of a SNP, 0 for an allele that is
+// common or has no carriers
+static void signatures(const SparseSnp *snp, const char *dense, const char *common, int numInd, const unsigned int *hashVal, char *row, unsigned int *sig, unsigned long int *band)
+{
+  int numHash = MINHASH_BANDS * MINHASH_ROWS; // values in each signature
+  int hashed[2]; // 1 for alleles with a signature
+
+  hashed[0] = !common[0] && (snp->count[0] + snp->count[1] > 0);
+  hashed[1] = !common[1] && (snp->count[1] + snp->count[2] > 0);
+
+  for (int b = 0; b < 2 * MINHASH_BANDS; b++)
+    band[b] = 0;
+
+  if (!hashed[0] && !hashed[1])
+    return;
+
+  expandSnp(snp, dense, numInd, row);
+
+  for (int k = 0; k < 2 * numHash; k++)
+    sig[k] = 0xffffffff;
+
+  for (int ind = 0; ind < numInd; ind++) {
+    const unsigned int *h = hashVal + (long int)ind * numHash; // values for this individual
+
+    if (hashed[0] && ((row[ind] == 0) || (row[ind] == 1))) // carries low allele
+      for (int k = 0; k < numHash; k++)
+	sig[k] = (h[k] < sig[k]) ? h[k] : sig[k];
+
+    if (hashed[1] && ((row[ind] == 1) || (row[ind] == 2))) // carries high allele
+      for (int k = 0; k < numHash; k++)
+	sig[numHash+k] = (h[k] < sig[numHash+k]) ? h[k] : sig[numHash+k];
+  }
+
+  for (int a = 0; a < 2; a++)
+    if (hashed[a])
+      for (int b = 0; b < MINHASH_BANDS; b++) {
+	unsigned long int h = (unsigned long int)b; // hash of band b
+	for (int r = 0; r < MINHASH_ROWS; r++)
+	  h = mix(h ^ sig[a*numHash + b*MINHASH_ROWS + r]);
+	band[a*MINHASH_BANDS + b] = h | 1; // never 0
+      }
+}
+
+
+void buildMinHash(MinHash *mh, const SnpSet *set1, const SnpSet *set2, int numInd, float thresh)
+{
+  int numHash = MINHASH_BANDS * MINHASH_ROWS; // values in each signature
+  unsigned int *hashVal; // random value of each individual for each hash function
+  unsigned int *sig; // signatures of both alleles of a SNP
+  unsigned long int band[2 * MINHASH_BANDS]; // band hashes of both alleles
+  char *row; // genotype codes of a SNP
+
+  mh->numBands = MINHASH_BANDS;
+  mh->numInd = numInd;
+  mh->numSnps1 = set1->numSnps;
+  mh->numSnps2 = set2->numSnps;
+  mh->cut = thresh / 4.5;
+
+  findBounds(&mh->bound1, set1, numInd);
+  findBounds(&mh->bound2, set2, numInd);
+
+  if (((hashVal = new unsigned int[(long int)numInd * numHash]) == NULL) || ((sig = new unsigned int[2 * numHash]) == NULL) || ((row = new char[numInd]) == NULL))
+    fatal("memory not allocated");
+  if (((mh->band1 = new unsigned long int[(long int)set1->numSnps * 2 * MINHASH_BANDS]) == NULL) || ((mh->bucketSize = new int[MINHASH_BANDS]) == NULL))
+    fatal("memory not allocated");
+  if ((mh->bucket = new BandEntry[(long int)set2->numSnps * 2 * MINHASH_BANDS]) == NULL)
+    fatal("memory not allocated");
+
+  for (long int n = 0; n < (long int)numInd * numHash; n++) // same values in every run
+    hashVal[n] = (unsigned int)mix(n);
+
+  for (int i = 0; i < set1->numSnps; i++)
+    signatures(&set1->snp[i], set1->data[i], mh->bound1.common + 2*i, numInd, hashVal, row, sig, mh->band1 + (long int)i * 2 * MINHASH_BANDS);
+
+  for (int b = 0; b < MINHASH_BANDS; b++)
+    mh->bucketSize[b] = 0;
+
+  for (int j = 0; j < set2->numSnps; j++) {
+    signatures(&set2->snp[j], set2->data[j], mh->bound2.common + 2*j, numInd, hashVal, row, sig, band);
+
+    for (int a = 0; a < 2; a++)
+      for (int b = 0; b < MINHASH_BANDS; b++)
+	if (band[a*MINHASH_BANDS + b] != 0) { // allele is bucketed
+	  BandEntry *entry = mh->bucket + (long int)b * 2 * set2->numSnps + mh->bucketSize[b]++;
+	  entry->hash = band[a*MINHASH_BANDS + b];
+	  entry->snp = j;
+	  entry->allele = a;
+	}
+  }
+
+  for (int b = 0; b < MINHASH_BANDS; b++) {
+    BandEntry *first = mh->bucket + (long int)b * 2 * set2->numSnps;
+    sort(first, first + mh->bucketSize[b], lessHash);
+  }
+
+  delete [] hashVal;
+  delete [] sig;
+  delete [] row;
+}
+
+
+int minHashPairs(const void *filter, int i, int firstJ, int *list, char *mark)
+{
+  const MinHash *mh = (const MinHash*)filter;
+  const AlleleBound *bd1 = &mh->bound1;
+  const AlleleBound *bd2 = &mh->bound2;
+  float cut = mh->cut - 2 * TOL; // TOL twice, to cover rounding of values
+  int live[2]; // 1 for alleles of SNP i that may reach cut with some allele
+  int num = 0; // number of SNPs listed
+
+  for (int a = 0; a < 2; a++) {
+    int n = mh->numInd - bd1->missing[i] - bd2->maxMissing; // fewest individuals without missing data
+    float frac = bd1->mass[2*i+a] / ((n > 1) ? n : 1);
+    live[a] = (((frac < 1) ? frac : 1) * bd1->factor[2*i+a] * bd2->maxFactor > cut);
+  }
+
+  if (!live[0] && !live[1])
+    return 0;
+
+  for (int j = firstJ; j < mh->numSnps2; j++) // pairs with a common allele, from bounds alone
+    for (int r = 0; r < 4; r++) {
+      int a = r/2, b = r%2; // alleles of SNPs i and j
+      if (live[a] && (bd1->common[2*i+a] || bd2->common[2*j+b]) && (pairBound(mh, i, a, j, b) > cut)) {
+	mark[j] = 1;
+	list[num++] = j;
+	break;
+      }
+    }
+
+  for (int a = 0; a < 2; a++) // pairs of uncommon alleles, from shared buckets
+    for (int b = 0; b < mh->numBands; b++) {
+      unsigned long int h = mh->band1[((long int)i * 2 + a) * mh->numBands + b];
+      if (!live[a] || (h == 0))
+	continue; // allele is not bucketed
+
+      const BandEntry *first = mh->bucket + (long int)b * 2 * mh->numSnps2;
+      const BandEntry *last = first + mh->bucketSize[b];
+      BandEntry key = {h, -1, 0}; // before all entries with this hash
+
+      for (const BandEntry *e = lower_bound(first, last, key, lessHash); (e < last) && (e->hash == h); e++)
+	if ((e->snp >= firstJ) && !mark[e->snp] && (pairBound(mh, i, a, e->snp, e->allele) > cut)) {
+	  mark[e->snp] = 1;
+	  list[num++] = e->snp;
+	}
+    }
+
+  for (int n = 0; n < num; n++) // leave marks cleared for next call
+    mark[list[n]] = 0;
+
+  sort(list, list + num); // same order as without a prefilter
+  return num;
+}
+
+
+void freeMinHash(MinHash *mh)
+{
+  delete [] mh->band1;
+  delete [] mh->bucket;
+  delete [] mh->bucketSize;
+  freeBounds(&mh->bound1);
+  freeBounds(&mh->bound2);
+}
+
+
+// pack genotype codes of chosen individuals into three bit planes
+static void packSnp(const SparseSnp *snp, const char *dense, int numInd, const int *chosen, int size, int numWords, char *row, unsigned long int *bits)
+{
+  expandSnp(snp, dense, numInd, row);
+
+  for (int w = 0; w < 3 * numWords; w++)
+    bits[w] = 0;
+
+  for (int s = 0; s < size; s++) {
+    char code = row[chosen[s]];
+    if (code < 3) // missing data is in no plane
+      bits[code * numWords + s / 64] |= 1UL << (s % 64);
+  }
+}
+
+
+void buildSubsample(Subsample *sub, const SnpSet *set1, const SnpSet *set2, int numInd, int size, float thresh, float margin)
+{
+  int *chosen; // individuals in subsample
+  char *row; // genotype codes of a SNP
+
+  if (size > numInd)
+    size = numInd;
+
+  sub->numInd = size;
+  sub->numWords = (size + 63) / 64;
+  sub->numSnps2 = set2->numSnps;
+  sub->freq1 = set1->freq;
+  sub->freq2 = set2->freq;
+  sub->cut = (thresh - margin) / 4.5;
+
+  if (((chosen = new int[numInd]) == NULL) || ((row = new char[numInd]) == NULL) || ((sub->tile = new PairTile) == NULL))
+    fatal("memory not allocated");
+  if (((sub->bits1 = new unsigned long int[(long int)set1->numSnps * 3 * sub->numWords]) == NULL) || ((sub->bits2 = new unsigned long int[(long int)set2->numSnps * 3 * sub->numWords]) == NULL))
+    fatal("memory not allocated");
+
+  for (int n = 0; n < numInd; n++)
+    chosen[n] = n;
+
+  for (int s = 0; s < size; s++) { // same subsample in every run
+    int r = s + (int)(mix(s) % (unsigned long int)(numInd - s));
+    int temp = chosen[s];
+    chosen[s] = chosen[r];
+    chosen[r] = temp;
+  }
+
+  sort(chosen, chosen + size); // read rows in order
+
+  for (int i = 0; i < set1->numSnps; i++)
+    packSnp(&set1->snp[i], set1->data[i], numInd, chosen, size, sub->numWords, row, sub->bits1 + (long int)i * 3 * sub->numWords);
+
+  for (int j = 0; j < set2->numSnps; j++)
+    packSnp(&set2->snp[j], set2->data[j], numInd, chosen, size, sub->numWords, row, sub->bits2 + (long int)j * 3 * sub->numWords);
+
+  allocTile(sub->tile);
+  delete [] chosen;
+  delete [] row;
+}
+
+
+int subsamplePairs(const void *filter, int i, int firstJ, int *list, char *)
+{
+  const Subsample *sub = (const Subsample*)filter;
+  PairTile *tile = sub->tile;
+  int numWords = sub->numWords;
+  const unsigned long int *p1 = sub->bits1 + (long int)i * 3 * numWords; // planes of SNP i
+  int num = 0; // number of SNPs listed
+
+  for (int tileStart = firstJ; tileStart < sub->numSnps2; tileStart += PAIR_BLOCK) {
+    int tileSize = sub->numSnps2 - tileStart; // number of pairs in this tile
+    if (tileSize > PAIR_BLOCK)
+      tileSize = PAIR_BLOCK;
+
+    for (int b = 0; b < tileSize; b++) {
+      const unsigned long int *p2 = sub->bits2 + (long int)(tileStart + b) * 3 * numWords;
+      int count[4][4] = {{0}}; // relationships in subsample (missing not needed)
+
+      for (int row = 0; row < 3; row++)
+	for (int col = 0; col < 3; col++) {
+	  const unsigned long int *a = p1 + row * numWords;
+	  const unsigned long int *c = p2 + col * numWords;
+	  int n = 0;
+	  for (int w = 0; w < numWords; w++)
+	    n += __builtin_popcountl(a[w] & c[w]);
+	  count[row][col] = n;
+	}
+
+      setTally(tile, b, count);
+    }
+
+    tileProducts(tile, tileSize, sub->freq1, i, sub->freq2, tileStart);
+    finaliseTile(tile, tileSize);
+
+    for (int b = 0; b < tileSize; b++) // keep pairs with no estimate
+      if ((tile->noMissing[b] == 0) || (tile->max[b] > sub->cut - TOL))
+	list[num++] = tileStart + b;
+  }
+
+  return num;
+}
+
+
+void freeSubsample(Subsample *sub)
+{
+  delete [] sub->bits1;
+  delete [] sub->bits2;
+  freeTile(sub->tile);
+  delete sub->tile;
+}
+
+
+void auditRecall(int (*candidates)(const void*, int, int, int*, char*), const void *filter, const SnpSet *set1, const SnpSet *set2, int numInd, float thresh, int numRows, FILE *logfile)
+{
+  int *list; // candidate SNPs of current row
+  char *mark; // work space for candidates()
+  char *isCand; // 1 for candidate SNPs of current row
+  PairTile tile; // arrays for a tile of pairs
+  long int numPairs = 0, numCand = 0; // pairs in sampled rows, and candidates among them
+  long int numEdges = 0, numFound = 0; // edges in sampled rows, and those among candidates
+
+  if (numRows > set1->numSnps)
+    numRows = set1->numSnps;
+
+  if (((list = new int[set2->numSnps]) == NULL) || ((mark = new char[set2->numSnps]) == NULL) || ((isCand = new char[set2->numSnps]) == NULL))
+    fatal("memory not allocated");
+
+  memset(mark, 0, set2->numSnps);
+  memset(isCand, 0, set2->numSnps);
+  allocTile(&tile);
+
+  for (int n = 0; n < numRows; n++) {
+    int i = (int)(((long int)n * set1->numSnps) / numRows); // evenly spaced rows
+    int firstJ = set1->start + i - set2->start + 1; // upper diagonal only
+    if (firstJ < 0)
+      firstJ = 0;
+
+    int num = candidates(filter, i, firstJ, list, mark);
+    for (int c = 0; c < num; c++)
+      isCand[list[c]] = 1;
+    numCand += num;
+
+    for (int tileStart = firstJ; tileStart < set2->numSnps; tileStart += PAIR_BLOCK) {
+      int tileSize = set2->numSnps - tileStart; // number of pairs in this tile
+      if (tileSize > PAIR_BLOCK)
+	tileSize = PAIR_BLOCK;
+
+      for (int b = 0; b < tileSize; b++) {
+	int j = tileStart + b;
+	int count[4][4]; // number of individuals with each relationship
+
+	pairTally(count, &set1->snp[i], set1->data[i], &set2->snp[j], set2->data[j], numInd);
+	setTally(&tile, b, count);
+      }
+
+      tileProducts(&tile, tileSize, set1->freq, i, set2->freq, tileStart);
+      finaliseTile(&tile, tileSize);
+      numPairs += tileSize;
+
+      for (int b = 0; b < tileSize; b++) { // same tests as for printing edges
+	int edges = 0;
+
+	if (!TWONODE)
+	  edges = (tile.max[b] > thresh - TOL);
+
+	else
+	  for (int r = 0; r < 4; r++)
+	    edges += (tile.value[r][b] > thresh - TOL);
+
+	numEdges += edges;
+	if (isCand[tileStart + b])
+	  numFound += edges;
+      }
+    }
+
+    for (int c = 0; c < num; c++)
+      isCand[list[c]] = 0;
+  }
+
+  freeTile(&tile);
+  delete [] list;
+  delete [] mark;
+  delete [] isCand;
+
+  double recall = (numEdges > 0) ? 100.0 * numFound / numEdges : 100.0;
+  double kept = (numPairs > 0) ? 100.0 * numCand / numPairs : 0.0;
+
+  cout << "Recall audit on " << numRows << " rows: " << numFound << " of " << numEdges << " edges (" << recall << "%) are in candidate pairs, which are " << kept << "% of pairs; " << numEdges - numFound << " edges missed." << endl;
+
+  if(LOG_FILE)
+    fprintf(logfile, "Recall audit on %d rows: %ld of %ld edges (%.2f%%) are in candidate pairs, which are %.2f%% of pairs; %ld edges missed.\n", numRows, numFound, numEdges, recall, kept, numEdges - numFound);
+}
@@ -0,0 +1,110 @@
+// -------------------------------------------------------------------------
+// prefilter.h -   Header file for choosing candidate pairs of SNPs before
+//                 the exact tallies are found
+//
+// Each allele of a SNP has a carrier set, the individuals with at least
+// one copy.  Alleles with a high CCC value share most of their carriers,
+// so their min-hash signatures agree in many places.  Signatures are
+// split into MINHASH_BANDS bands of MINHASH_ROWS values, and the alleles
+// of the second set are bucketed by the hash of each band (locality
+// sensitive hashing).  Only alleles carried by fewer than
+// MINHASH_CARRIERS of the individuals are bucketed, as the carrier sets
+// of common alleles overlap whether or not they are correlated.
+//
+// The value of a pair of alleles is at most the smaller of their
+// frequencies (over the individuals without missing data for the pair)
+// times both frequency factors.  A pair of SNPs is a candidate when this
+// bound reaches the threshold for two of their alleles that share a
+// bucket for at least one band, or for two alleles of which at least one
+// is common.  Only candidates are tallied.
+//
+// Alternatively, CCC values are estimated from a subsample of the
+// individuals, held as bit planes of 64-bit words (one plane for each
+// genotype code) so a pair is tallied with a few popcounts per word.  A
+// pair is a candidate when its estimate is within a margin of the
+// threshold, and candidates are then evaluated over all individuals.
+//
+// Pairs that are not candidates are never evaluated, so edges can be
+// missed.  The recall is measured by evaluating every pair for a sample
+// of rows and counting the edges that are among the candidates.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _PREFILTER_H
+#define _PREFILTER_H
+
+#include "bloc.h"
+#include "sparse.h"
+#include "tile.h"
+
+struct BandEntry
+{
+  unsigned long int hash; // hash of one band of an allele's signature
+  int snp; // index of SNP in second set
+  int allele; // 0 for lowest allele, 1 for highest
+};
+
+struct AlleleBound // what a pair's value is bounded by, for each allele
+{
+  float *mass; // copies of both alleles of each SNP over all individuals, halved
+  float *factor; // frequency factors of both alleles (1 if FREQ is 0)
+  char *common; // 1 for alleles that aren't bucketed
+  int *missing; // individuals with missing data for each SNP
+  float maxFactor; // largest factor in set
+  int maxMissing; // largest number missing in set
+};
+
+struct MinHash
+{
+  int numBands; // number of bands in each signature
+  int numInd; // number of individuals
+  int numSnps1; // number of SNPs in first set
+  int numSnps2; // number of SNPs in second set
+  float cut; // unscaled value a bound must reach
+  unsigned long int *band1; // band hashes of both alleles of first set (0 if not bucketed)
+  BandEntry *bucket; // entries of second set for each band, sorted by hash
+  int *bucketSize; // number of entries for each band
+  AlleleBound bound1; // bounds of first set
+  AlleleBound bound2; // bounds of second set
+};
+
+// find signatures and bounds of both sets and bucket the second set, for
+// edges above thresh (scaled)
+void buildMinHash(MinHash *mh, const SnpSet *set1, const SnpSet *set2, int numInd, float thresh);
+
+// list candidate SNPs of second set (from firstJ on) for SNP i of first
+// set in increasing order, return number listed (mark holds numSnps2 zeros)
+int minHashPairs(const void *filter, int i, int firstJ, int *list, char *mark);
+
+void freeMinHash(MinHash *mh);
+
+struct Subsample
+{
+  int numInd; // number of individuals in subsample
+  int numWords; // 64-bit words in each bit plane
+  int numSnps2; // number of SNPs in second set
+  unsigned long int *bits1; // three bit planes for each SNP of first set
+  unsigned long int *bits2; // three bit planes for each SNP of second set
+  const FreqVec *freq1; // frequency factors of full data
+  const FreqVec *freq2;
+  float cut; // unscaled value an estimate must exceed
+  PairTile *tile; // work space for estimates
+};
+
+// choose size individuals and pack the genotypes of both sets over them,
+// keeping pairs with estimates above (thresh - margin) (both scaled)
+void buildSubsample(Subsample *sub, const SnpSet *set1, const SnpSet *set2, int numInd, int size, float thresh, float margin);
+
+// list SNPs of second set (from firstJ on) whose estimated value with
+// SNP i of first set is high enough, in increasing order (mark unused)
+int subsamplePairs(const void *filter, int i, int firstJ, int *list, char *mark);
+
+void freeSubsample(Subsample *sub);
+
+// evaluate every pair of numRows sampled rows and log the fraction of
+// edges whose pairs are listed by candidates()
+void auditRecall(int (*candidates)(const void*, int, int, int*, char*), const void *filter, const SnpSet *set1, const SnpSet *set2, int numInd, float thresh, int numRows, FILE *logfile);
+
+#endif
@@ -0,0 +1,129 @@
+/****************************************************************************
+*
+*	progress.cpp:	Progress, throughput and time estimates for long
+*                       ccc runs.
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include <sys/time.h>
+#include "progress.h"
+
+using namespace std;
+
+double wallTime()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec + 0.000001 * (double)tv.tv_usec;
+}
+
+
+long int residentBytes()
+{
+  FILE *statm;
+  long int size = 0; // total program size in pages
+  long int resident = 0; // resident set size in pages
+
+  if ((statm = fopen("/proc/self/statm", "r")) == NULL)
+    return 0; // not available on this system
+
+  if (fscanf(statm, "%ld %ld", &size, &resident) != 2)
+    resident = 0;
+  fclose(statm);
+
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+
+long int peakResidentBytes()
+{
+  FILE *status;
+  char strng[200]; // temporary string storage
+  long int peak = 0; // peak resident set size in kB
+
+  if ((status = fopen("/proc/self/status", "r")) == NULL)
+    return 0; // not available on this system
+
+  while (fscanf(status, "%199s", strng) == 1)
+    if (strcmp(strng, "VmHWM:") == 0) {
+      fscanf(status, "%ld", &peak);
+      break;
+    }
+  fclose(status);
+
+  return peak * 1024;
+}
+
+
+void startProgress(Progress *prog, int interval, long int totalPairs, long int pairsDone, long int numEdges)
+{
+  prog->interval = interval;
+  prog->totalPairs = totalPairs;
+  prog->startPairs = pairsDone;
+  prog->startEdges = numEdges;
+  prog->pairsDone = pairsDone;
+  prog->numEdges = numEdges;
+  prog->bytes = 0;
+  prog->startTime = wallTime();
+  prog->lastReport = prog->startTime;
+}
+
+
+void updateProgress(Progress *prog, long int pairsDone, long int numEdges, long int bytes, FILE *logfile)
+{
+  prog->pairsDone = pairsDone;
+  prog->numEdges = numEdges;
+  prog->bytes = bytes;
+
+  if (prog->interval <= 0)
+    return; // reports turned off
+
+  double now = wallTime();
+  if (now - prog->lastReport < prog->interval)
+    return; // not time for a report yet
+
+  prog->lastReport = now;
+
+  double seconds = now - prog->startTime; // rates are for this process only
+  double pairRate = (pairsDone - prog->startPairs) / seconds;
+  double edgeRate = (numEdges - prog->startEdges) / seconds;
+  double percent = 100.0 * (double)pairsDone / (double)prog->totalPairs;
+  double eta = (pairRate > 0) ? (prog->totalPairs - pairsDone) / pairRate : -1;
+
+  if(LOG_FILE) {
+    fprintf(logfile, "Progress: %ld of %ld pairs (%.2f%%), %.0f pairs/sec, %.1f edges/sec, %ld bytes written, %.1f MB resident, ETA %.0f seconds\n", pairsDone, prog->totalPairs, percent, pairRate, edgeRate, prog->bytes, residentBytes() / 1048576.0, eta);
+    fflush(logfile);
+  }
+
+  if (!QUIET)
+    cout << "Progress: " << percent << "% of pairs, ETA " << eta << " seconds" << endl;
+}
+
+
+void writeStats(const char *fileName, Progress *prog, float thresh, float minBloc, float maxBloc)
+{
+  FILE *output;
+
+  if ((output = fopen(fileName, "w")) == NULL)
+    fatal("Stats file could not be opened.\n");
+
+  double seconds = wallTime() - prog->startTime;
+
+  fprintf(output, "threshold\t%f\n", thresh);
+  fprintf(output, "pairs\t%ld\n", prog->pairsDone);
+  fprintf(output, "pairsThisRun\t%ld\n", prog->pairsDone - prog->startPairs);
+  fprintf(output, "edges\t%ld\n", prog->numEdges);
+  fprintf(output, "edgesThisRun\t%ld\n", prog->numEdges - prog->startEdges);
+  fprintf(output, "seconds\t%f\n", seconds);
+  fprintf(output, "pairsPerSec\t%f\n", (seconds > 0) ? (prog->pairsDone - prog->startPairs) / seconds : 0.0);
+  fprintf(output, "edgesPerSec\t%f\n", (seconds > 0) ? (prog->numEdges - prog->startEdges) / seconds : 0.0);
+  fprintf(output, "bytesWritten\t%ld\n", prog->bytes);
+  fprintf(output, "peakResidentBytes\t%ld\n", peakResidentBytes());
+  fprintf(output, "minCCC\t%f\n", minBloc);
+  fprintf(output, "maxCCC\t%f\n", maxBloc);
+
+  fclose(output);
+}
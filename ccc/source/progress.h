@@ -0,0 +1,43 @@
+// -------------------------------------------------------------------------
+// progress.h -   Header file for progress reports of long ccc runs
+//
+// Counters are updated once per row of the first SNP set, so reporting
+// costs nothing inside the pair loop.  Reports are written to the log
+// file at a fixed interval and a summary is written to a stats file.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _PROGRESS_H
+#define _PROGRESS_H
+
+#include "bloc.h"
+
+struct Progress
+{
+  int interval; // seconds between reports (0 for none)
+  long int totalPairs; // pairs to be computed in entire run
+  long int startPairs; // pairs already done when this process started
+  long int startEdges; // edges already printed when this process started
+  long int pairsDone; // pairs completed so far
+  long int numEdges; // edges printed so far
+  long int bytes; // bytes of edge output written so far
+  double startTime; // wall clock time when this process started
+  double lastReport; // wall clock time of last report
+};
+
+double wallTime(); // wall clock time in seconds
+long int residentBytes(); // current resident memory of this process
+long int peakResidentBytes(); // peak resident memory of this process
+
+void startProgress(Progress *prog, int interval, long int totalPairs, long int pairsDone, long int numEdges);
+
+// update counters, with the bytes of edge output written so far, and
+// write a report if the interval has passed
+void updateProgress(Progress *prog, long int pairsDone, long int numEdges, long int bytes, FILE *logfile);
+
+// write machine-readable summary of the run (tab-separated name and value)
+void writeStats(const char *fileName, Progress *prog, float thresh, float minBloc, float maxBloc);
+
+#endif
@@ -0,0 +1,169 @@
+/****************************************************************************
+*
+*	sparse.cpp:	Sparse storage of rare-variant SNPs and tallies
+*                       of genotype combinations for pairs of SNPs
+*                       when at least one of them is stored sparsely.
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include "sparse.h"
+
+using namespace std;
+
+int makeSparse(const char *row, int numInd, float maxFrac, SparseSnp *snp)
+{
+  for (int c = 0; c < 4; c++)
+    snp->count[c] = 0;
+
+  for (int k = 0; k < numInd; k++)
+    snp->count[row[k]]++; // count individuals with each genotype code
+
+  if (!planSparse(numInd, maxFrac, snp))
+    return 0; // too many individuals differ, keep dense row
+
+  int ptr = 0; // pointer for filling lists in order of individuals
+  for (int k = 0; k < numInd; k++)
+    if (row[k] != snp->common) {
+      snp->ind[ptr] = k;
+      snp->code[ptr++] = row[k];
+    }
+
+  return 1;
+}
+
+
+int planSparse(int numInd, float maxFrac, SparseSnp *snp)
+{
+  snp->common = 0; // find most common code
+  for (int c = 1; c < 4; c++)
+    if (snp->count[c] > snp->count[snp->common])
+      snp->common = c;
+
+  snp->numRare = numInd - snp->count[snp->common];
+  snp->sparse = 0;
+  snp->ind = NULL;
+  snp->code = NULL;
+
+  if (snp->numRare > maxFrac * (float)numInd)
+    return 0; // too many individuals differ, keep dense row
+
+  if (snp->numRare > 0)
+    if (((snp->ind = new int[snp->numRare]) == NULL) || ((snp->code = new char[snp->numRare]) == NULL))
+      fatal("memory not allocated");
+
+  snp->sparse = 1;
+  return 1;
+}
+
+
+void sparseTally(int tally[4][4], const SparseSnp *snp1, const char *row1, const SparseSnp *snp2, const char *row2, int numInd)
+{
+  for (int a = 0; a < 4; a++)
+    for (int b = 0; b < 4; b++)
+      tally[a][b] = 0;
+
+  if (snp1->sparse && snp2->sparse) { // intersect the two sorted lists
+    int p = 0; // pointer into first list
+    int q = 0; // pointer into second list
+
+    while ((p < snp1->numRare) && (q < snp2->numRare)) {
+      if (snp1->ind[p] == snp2->ind[q]) // rare for both SNPs
+	tally[snp1->code[p++]][snp2->code[q++]]++;
+
+      else if (snp1->ind[p] < snp2->ind[q]) // rare for first SNP only
+	tally[snp1->code[p++]][snp2->common]++;
+
+      else // rare for second SNP only
+	tally[snp1->common][snp2->code[q++]]++;
+    }
+
+    while (p < snp1->numRare)
+      tally[snp1->code[p++]][snp2->common]++;
+
+    while (q < snp2->numRare)
+      tally[snp1->common][snp2->code[q++]]++;
+
+    // remaining individuals have the common code for both SNPs
+    int rest = numInd;
+    for (int a = 0; a < 4; a++)
+      for (int b = 0; b < 4; b++)
+	rest -= tally[a][b];
+    tally[snp1->common][snp2->common] = rest;
+
+    return;
+  }
+
+  if (snp1->sparse) { // look up second SNP for rare individuals of first
+    for (int p = 0; p < snp1->numRare; p++)
+      tally[snp1->code[p]][row2[snp1->ind[p]]]++;
+
+    // common individuals of first SNP make up rest of each marginal count
+    for (int b = 0; b < 4; b++) {
+      int rest = snp2->count[b];
+      for (int a = 0; a < 4; a++)
+	if (a != snp1->common)
+	  rest -= tally[a][b];
+      tally[snp1->common][b] = rest;
+    }
+
+    return;
+  }
+
+  if (!snp2->sparse)
+    fatal("sparseTally called for two dense SNPs");
+
+  for (int q = 0; q < snp2->numRare; q++) // look up first SNP for rare individuals of second
+    tally[row1[snp2->ind[q]]][snp2->code[q]]++;
+
+  for (int a = 0; a < 4; a++) {
+    int rest = snp1->count[a];
+    for (int b = 0; b < 4; b++)
+      if (b != snp2->common)
+	rest -= tally[a][b];
+    tally[a][snp2->common] = rest;
+  }
+}
+
+
+void pairTally(int tally[4][4], const SparseSnp *snp1, const char *row1, const SparseSnp *snp2, const char *row2, int numInd)
+{
+  if (snp1->sparse || snp2->sparse) { // use lists of rare individuals
+    sparseTally(tally, snp1, row1, snp2, row2, numInd);
+    return;
+  }
+
+  for (int row = 0; row < 4; row++)
+    for (int col = 0; col < 4; col++)
+      tally[row][col] = 0;
+
+  for (int k = 0; k < numInd; k++)
+    tally[row1[k]][row2[k]]++;
+}
+
+
+void expandSnp(const SparseSnp *snp, const char *dense, int numInd, char *row)
+{
+  if (!snp->sparse) {
+    memcpy(row, dense, numInd);
+    return;
+  }
+
+  memset(row, snp->common, numInd);
+  for (int q = 0; q < snp->numRare; q++)
+    row[snp->ind[q]] = snp->code[q];
+}
+
+
+void freeSparse(SparseSnp *snp)
+{
+  if (snp->ind != NULL)
+    delete [] snp->ind;
+  if (snp->code != NULL)
+    delete [] snp->code;
+
+  snp->ind = NULL;
+  snp->code = NULL;
+}
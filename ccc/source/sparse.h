@@ -0,0 +1,58 @@
+// -------------------------------------------------------------------------
+// sparse.h -   Header file for sparse storage of rare-variant SNPs
+//
+// A SNP whose genotypes are nearly all one code is held as a sorted
+// list of the individuals that carry any other code (including missing).
+// Tallies for a pair are then found from the lists and the marginal
+// counts of each code, without scanning every individual.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _SPARSE_H
+#define _SPARSE_H
+
+#include "bloc.h"
+
+struct SparseSnp
+{
+  int sparse; // 1 if stored as a list, 0 if dense row is used (Boolean)
+  char common; // genotype code held by most individuals
+  int count[4]; // number of individuals with each genotype code
+  int numRare; // number of individuals without the common code
+  int *ind; // sorted indices of individuals without the common code
+  char *code; // genotype code for each of these individuals
+};
+
+struct SnpSet // one set of SNPs with its genotypes and frequency factors
+{
+  int numSnps; // number of SNPs in set
+  int start; // index of first SNP in input file (from zero)
+  char **data; // dense rows (NULL for sparse SNPs)
+  SparseSnp *snp; // counts and lists of rare individuals
+  const FreqVec *freq; // frequency factors
+};
+
+// count codes in row and convert to list if few individuals differ from
+// the most common code, return 1 if converted
+int makeSparse(const char *row, int numInd, float maxFrac, SparseSnp *snp);
+
+// as above, given the counts of each code already in snp: find the
+// common code and, if few individuals differ from it, allocate lists for
+// numRare individuals to be filled in order; return 1 if sparse
+int planSparse(int numInd, float maxFrac, SparseSnp *snp);
+
+// tally the 16 genotype combinations for a pair when at least one SNP
+// is sparse (dense rows may be NULL for sparse SNPs)
+void sparseTally(int tally[4][4], const SparseSnp *snp1, const char *row1, const SparseSnp *snp2, const char *row2, int numInd);
+
+// tally the 16 genotype combinations for any pair, sparse or dense
+void pairTally(int tally[4][4], const SparseSnp *snp1, const char *row1, const SparseSnp *snp2, const char *row2, int numInd);
+
+// write the genotype code of every individual to row, from either form
+void expandSnp(const SparseSnp *snp, const char *dense, int numInd, char *row);
+
+void freeSparse(SparseSnp *snp); // release list memory
+
+#endif
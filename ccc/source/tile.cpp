@@ -0,0 +1,139 @@
+/****************************************************************************
+*
+*	tile.cpp:	Evaluation of CCC values for a tile of pairs of
+*                       SNPs, laid out as arrays so that the loops can 
+*                       be vectorised.
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include "tile.h"
+
+using namespace std;
+
+void allocTile(PairTile *tile)
+{
+  for (int r = 0; r < 4; r++) {
+    tile->tally4[r] = (int*)alignedAlloc(PAIR_BLOCK * sizeof(int));
+    tile->prod[r] = (double*)alignedAlloc(PAIR_BLOCK * sizeof(double));
+    tile->value[r] = (float*)alignedAlloc(PAIR_BLOCK * sizeof(float));
+  }
+
+  tile->noMissing = (int*)alignedAlloc(PAIR_BLOCK * sizeof(int));
+  tile->max = (float*)alignedAlloc(PAIR_BLOCK * sizeof(float));
+}
+
+
+void freeTile(PairTile *tile)
+{
+  for (int r = 0; r < 4; r++) {
+    free(tile->tally4[r]);
+    free(tile->prod[r]);
+    free(tile->value[r]);
+  }
+
+  free(tile->noMissing);
+  free(tile->max);
+}
+
+
+void setTally(PairTile *tile, int b, const int count[4][4])
+{
+  // four times the weighted tallies of each relationship, as the
+  // heterozygous relationships contribute one half or one quarter
+  tile->tally4[0][b] = 4*count[0][0] + 2*count[0][1] + 2*count[1][0] + count[1][1];
+  tile->tally4[1][b] = 2*count[0][1] + 4*count[0][2] + count[1][1] + 2*count[1][2];
+  tile->tally4[2][b] = 2*count[1][0] + count[1][1] + 4*count[2][0] + 2*count[2][1];
+  tile->tally4[3][b] = count[1][1] + 2*count[1][2] + 2*count[2][1] + 4*count[2][2];
+
+  int noMissing = 0; // individuals with no missing data for either SNP
+  for (int row = 0; row < 3; row++)
+    for (int col = 0; col < 3; col++)
+      noMissing += count[row][col];
+  tile->noMissing[b] = noMissing;
+}
+
+
+void tileProducts(PairTile *tile, int size, const FreqVec *freq1, int i, const FreqVec *freq2, int tileStart)
+{
+  // relationship r uses allele r/2 of first SNP and allele r%2 of second
+  for (int r = 0; r < 4; r++) {
+    double *prod = tile->prod[r];
+
+    if (!FREQ) { // values are not multiplied by frequency factors
+      for (int b = 0; b < size; b++)
+	prod[b] = 1.0;
+      continue;
+    }
+
+    double f1 = freq1->f[r/2][i]; // factor for first SNP
+    const double *f2 = freq2->f[r%2] + tileStart; // factors for second SNPs
+
+    for (int b = 0; b < size; b++)
+      prod[b] = f1 * f2[b];
+  }
+}
+
+
+void tileProductsAt(PairTile *tile, int size, const FreqVec *freq1, int i, const FreqVec *freq2, const int *index)
+{
+  for (int r = 0; r < 4; r++) {
+    double *prod = tile->prod[r];
+
+    if (!FREQ) {
+      for (int b = 0; b < size; b++)
+	prod[b] = 1.0;
+      continue;
+    }
+
+    double f1 = freq1->f[r/2][i];
+    const double *f2 = freq2->f[r%2];
+
+    for (int b = 0; b < size; b++) // gather factors of listed SNPs
+      prod[b] = f1 * f2[index[b]];
+  }
+}
+
+
+void finaliseTile(PairTile *tile, int size)
+{
+  const int *ll4 = tile->tally4[0];
+  const int *lh4 = tile->tally4[1];
+  const int *hl4 = tile->tally4[2];
+  const int *hh4 = tile->tally4[3];
+  const int *noMissing = tile->noMissing;
+  const double *prodLL = tile->prod[0];
+  const double *prodLH = tile->prod[1];
+  const double *prodHL = tile->prod[2];
+  const double *prodHH = tile->prod[3];
+  float *ll = tile->value[0];
+  float *lh = tile->value[1];
+  float *hl = tile->value[2];
+  float *hh = tile->value[3];
+  float *max = tile->max;
+
+  // tallies times 0.25 are exactly the weighted sums of the original
+  // float computation, and each step rounds as it did there, so the
+  // values are identical to evaluating one pair at a time
+  for (int b = 0; b < size; b++) {
+    float n = (float)noMissing[b];
+
+    float vll = (float)((double)(((float)ll4[b] * 0.25f) / n) * prodLL[b]);
+    float vlh = (float)((double)(((float)lh4[b] * 0.25f) / n) * prodLH[b]);
+    float vhl = (float)((double)(((float)hl4[b] * 0.25f) / n) * prodHL[b]);
+    float vhh = (float)((double)(((float)hh4[b] * 0.25f) / n) * prodHH[b]);
+
+    float m = vll; // find maximum value
+    m = (vlh > m) ? vlh : m;
+    m = (vhl > m) ? vhl : m;
+    m = (vhh > m) ? vhh : m;
+
+    ll[b] = vll;
+    lh[b] = vlh;
+    hl[b] = vhl;
+    hh[b] = vhh;
+    max[b] = m;
+  }
+}
@@ -0,0 +1,44 @@
+// -------------------------------------------------------------------------
+// tile.h -   Header file for evaluating pairs of SNPs in tiles
+//
+// A tile holds the pairs formed by one SNP of the first set and a block
+// of up to PAIR_BLOCK consecutive SNPs of the second set.  Tallies and
+// products of frequency factors are stored as aligned arrays, one per
+// relationship, so the values and their maximum are found for the whole
+// tile in one loop that the compiler can vectorise.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _TILE_H
+#define _TILE_H
+
+#include "bloc.h"
+
+struct PairTile
+{
+  int *tally4[4]; // four times weighted tallies of ll, lh, hl and hh
+  int *noMissing; // individuals with no missing data for each pair
+  double *prod[4]; // products of frequency factors for ll, lh, hl and hh
+  float *value[4]; // values of ll, lh, hl and hh (unscaled)
+  float *max; // maximum of the four values
+};
+
+void allocTile(PairTile *tile); // allocate aligned arrays for PAIR_BLOCK pairs
+void freeTile(PairTile *tile); // release arrays
+
+// store weighted tallies and number without missing data for pair b
+void setTally(PairTile *tile, int b, const int count[4][4]);
+
+// find products of the frequency factors of SNP i of the first set with
+// those of SNPs tileStart onward of the second set
+void tileProducts(PairTile *tile, int size, const FreqVec *freq1, int i, const FreqVec *freq2, int tileStart);
+
+// as above, for the SNPs of the second set listed in index
+void tileProductsAt(PairTile *tile, int size, const FreqVec *freq1, int i, const FreqVec *freq2, const int *index);
+
+// find the four values and their maximum for the first size pairs of tile
+void finaliseTile(PairTile *tile, int size);
+
+#endif
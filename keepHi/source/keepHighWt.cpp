@@ -6,6 +6,12 @@
 *                       Sharlee Climer
 *                       June 2011
 *
+*      .gml files are mapped into memory and read with gmlscan.
+*      October 2026
+*
+*      Graph files saved by bfs are mapped and filtered in place.
+*      October 2026
+*
 *
 ****************************************************************************/
   
@@ -30,9 +36,31 @@ int main(int argc, char ** argv)
   FILE *input;
   FILE *output;
   
-  if ((input = fopen(argv[1], "r")) == NULL) 
+  if ((input = fopen(argv[1], "rb")) == NULL) 
     fatal("File could not be opened.\n");
 
+  GraphFile graph; // CSR arrays written by 'bfs --save', used in place
+  int mappedGraph = mapGraph(&graph, input); // 1 if input is a graph file
+
+  if (mappedGraph < 0)
+    fatal("Graph file is damaged");
+
+  int binNodes; // number of nodes in header of binary edge file
+  int binary = !mappedGraph && readBinaryHead(input, &binNodes); // 1 if written by 'ccc --binary'
+  int frameBinary; // 1 if frames hold binary records
+  int framed = !mappedGraph && !binary && readFrameHead(input, &binNodes, &frameBinary); // 1 if written by 'ccc --framed'
+  int text = !mappedGraph && !binary && !framed; // 1 if input is a .gml file
+
+  FramedEdge *framedEdge = NULL; // edges of framed file, decompressed in parallel
+  long int numFramed = 0; // number of edges in framed file
+
+  if (framed && ((numFramed = readFramedEdges(input, &framedEdge)) < 0))
+    fatal("Framed input file is damaged");
+
+  GmlScanner gml; // .gml file mapped into memory, for both passes
+  if (text && !openGml(&gml, input))
+    fatal(gml.error);
+
   long int numNodes = atoi(argv[2]); // number of nodes
   long int numEdges = atoi(argv[3]); // number of edges in original network
   long int numKeep = atoi(argv[4]); // number of edges to keep 
@@ -40,7 +68,6 @@ int main(int argc, char ** argv)
   int numTies = 0; // number of edges added due to ties
   long int countNodes = 0; // count nodes for data checking
   long int countEdges = 0; // count edges for data checking
-  char strng[200]; // temporary string storage
 
   // check validity of values
   if (numNodes < 1)
@@ -59,31 +86,24 @@ int main(int argc, char ** argv)
 
   int startOne; // 1 if start node number is 1, 0 if start number is 0
 
-  while (1) { // read in until get to "graph" declaration
-    if(feof(input)) fatal("no graph to read in input file");
-
-    fscanf(input, "%s", strng); // read in string from file
-
-    if(strncmp(strng, "graph", 5) == 0) 
-      break; // stop when get to "graph" declaration
+  if (binary || framed) { // nodes are numbered from 1
+    min = 1;
+    max = binNodes;
+    countNodes = binNodes;
   }
 
-  while (1) { // throw away everything until get to "edge" declaration
-    if(feof(input)) fatal("no edges to read in input file");
-
-    fscanf(input, "%s", strng); // read in string from file
-
-    if(strncmp(strng, "id", 2) == 0) { 
-      fscanf(input, "%s", strng); // read in id value
-      int num = atoi(strng);
-
-      if(min > num) min = num; // update minimum node number
-      if(max < num) max = num; // update maximum node number
-      countNodes++; // one more node found
+  if (mappedGraph) { // node ids are stored with the arrays
+    for (int i = 0; i < graph.numNodes; i++) {
+      if(min > graph.id[i]) min = graph.id[i]; // update minimum node number
+      if(max < graph.id[i]) max = graph.id[i]; // update maximum node number
     }
+    countNodes = graph.numNodes;
+  }
 
-    if(strncmp(strng, "edge", 4) == 0) 
-      break; // stop when read in first "edge"
+  if (text) { // node ids were read when file was opened
+    min = gml.minId;
+    max = gml.maxId;
+    countNodes = gml.numNodes;
   }
 
   if(!QUIET)
@@ -107,73 +127,69 @@ int main(int argc, char ** argv)
   if(max != numNodes - 1 + startOne)
     fatal("Error on maximum node number");
 
-  float *weights; 
-  if ((weights = new float[numEdges]) == NULL)
+  // binary and graph files only hold quantised weights (see weights.h);
+  // .gml and framed files are ranked by the weights as read
+  int quantised = binary || mappedGraph; // 1 if weights are quantised
+  unsigned short *weights = NULL; // quantised weights
+  float *floatWts = NULL; // weights as read
+
+  if (quantised && ((weights = new unsigned short[numEdges]) == NULL))
+    fatal("memory not allocated");
+  if (!quantised && ((floatWts = new float[numEdges]) == NULL))
     fatal("memory not allocated");
 
   // read in edge weights
 
-  while (!feof(input)) { // read edges until reach end of file
-    fscanf(input, "%s", strng); // read in string from file
+  int source, target; // endpoints of current edge
+  unsigned short binWeight; // weight of current edge in binary file
 
-    if(!strncmp(strng, "[", 1) == 0) // check for correct character
-      fatal("No '[' after edge declaration");
-
-    fscanf(input, "%s", strng); // read in string from file
-    if(!strncmp(strng, "source", 6) == 0) // check for correct character
-      fatal("No 'source' declaration");
+  while (binary && readBinaryEdge(input, &source, &target, &binWeight)) {
+    if((source < min) || (source > max) || (target < min) || (target > max))
+      fatal("Invalid node number");
 
-    fscanf(input, "%s", strng); // read in start node from file
-    int source = atoi(strng);
+    if(countEdges == numEdges)
+      fatal("Incorrect number of edges in input file");
+    weights[countEdges++] = binWeight;
+  }
 
-    if((source < min) || (source > max))
+  for (long int e = 0; e < numFramed; e++) {
+    source = framedEdge[e].source;
+    target = framedEdge[e].target;
+    if((source < min) || (source > max) || (target < min) || (target > max))
       fatal("Invalid node number");
 
-    //cout << "source: " << idInv[source];
-
-    fscanf(input, "%s", strng); // read in string from file
-    if(!strncmp(strng, "target", 6) == 0) // check for correct character
-      fatal("No 'target' declaration");
+    if(countEdges == numEdges)
+      fatal("Incorrect number of edges in input file");
+    floatWts[countEdges++] = framedEdge[e].weight;
+  }
 
-    fscanf(input, "%s", strng); // read in target node from file
-    int target = atoi(strng);
+  float weight; // weight of current edge in .gml file
+  int hasWeight; // 1 if weight given (Boolean)
+  int found; // 1 if edge read, 0 at end of graph, -1 on error
 
-    if((target < min) || (target > max))
-      fatal("Invalid node number");
+  if (mappedGraph) { // weights are already one contiguous array
+    if (graph.numEdges != numEdges)
+      fatal("Incorrect number of edges in input file");
+    memcpy(weights, graph.weight, numEdges * sizeof(unsigned short));
+    countEdges = numEdges;
+  }
 
-    //cout << ", target: " << idInv[target];
+  while (text && ((found = nextGmlEdge(&gml, &source, &target, &weight, &hasWeight)) != 0)) {
+    if (found < 0)
+      fatal(gml.error);
 
-    fscanf(input, "%s", strng); // read in string from file
+    if((source < min) || (source > max) || (target < min) || (target > max))
+      fatal("Invalid node number");
 
-    if(strncmp(strng, "weight", 6) == 0) {// check to see if weight specified
-      fscanf(input, "%s", strng); // read in string from file
-      weights[countEdges] = atof(strng);
-      fscanf(input, "%s", strng); // read in string from file
-    }
-    else
+    if (!hasWeight)
       fatal("All edges must have a weight specified");
 
-    //cout << ", weight: " << weight << endl;
-    
-    countEdges++; // count number of edges
+    if(countEdges == numEdges)
+      fatal("Incorrect number of edges in input file");
+    floatWts[countEdges++] = weight;
 
     if(countEdges % 10000000 == 0) // message every 10 million edges
       cout << countEdges / 1000000 << " million edges read" << endl;
-
-    if(!strncmp(strng, "]", 1) == 0) // check for correct character
-      fatal("No ']' after edge declaration");
-
-    //fprintf(output, "%d\t%d\t%f\n", source, target, weight);
-
-    //if (feof(input)) break; // break as at end of file
-
-    fscanf(input, "%s", strng); // read in string from file
-
-    if(strncmp(strng, "]", 1) == 0) // check for end of graph
-      break;
-
-    if(!strncmp(strng, "edge", 4) == 0) // check for correct character
-      fatal("No 'edge' declaration");
   }
 
   fclose(input);
@@ -184,98 +200,93 @@ int main(int argc, char ** argv)
   if (VERBOSE) {
     cout << "Weights of original edges:" << endl;
     for (int i = 0; i < numEdges; i++)
-      cout << weights[i] << " ";
+      cout << (quantised ? weightValue(weights[i]) : floatWts[i]) << " ";
     cout << "\n" << endl;
   }
 
-  std::sort(weights, weights + numEdges); // sort data using quicksort
+  if (quantised)
+    std::sort(weights, weights + numEdges); // sort data using quicksort
+  else
+    std::sort(floatWts, floatWts + numEdges);
 
   if (VERBOSE) {
     cout << "Sorted edge weights:" << endl;
     for (int i = 0; i < numEdges; i++)
-      cout << weights[i] << " ";
+      cout << (quantised ? weightValue(weights[i]) : floatWts[i]) << " ";
     cout << "\n" << endl;
   }
 
   // determine minimum weight edge to keep
-  float minWt = weights[numEdges - numKeep]; // values are in increasing order
+  float minWt; // values are in increasing order
+  if (quantised)
+    minWt = weightValue(weights[numEdges - numKeep]);
+  else
+    minWt = floatWts[numEdges - numKeep];
   minWt -= 0.00001; // capture edges within tolerance level 
 
   cout << "Edges with weight of " << minWt << " or higher will be kept." << endl;
 
   // read in old edges and write out ones to keep
 
-  if (((input = fopen(argv[1], "r")) == NULL) || ((output = fopen(argv[5], "w")) == NULL))
+  if ((output = fopen(argv[5], "w")) == NULL)
+    fatal("File could not be opened.\n");
+  if (binary && ((input = fopen(argv[1], "rb")) == NULL)) // .gml file is still mapped
     fatal("File could not be opened.\n");
 
   fprintf(output, "Graph with %d nodes.\ngraph\n[\n",numNodes);
 
-  while (1) { // read in until get to "graph" declaration
-    if(feof(input)) fatal("no graph to read in input file");
-
-    fscanf(input, "%s", strng); // read in string from file
-
-    if(strncmp(strng, "graph", 5) == 0) 
-      break; // stop when get to "graph" declaration
-  }
+  if (binary) // skip header
+    readBinaryHead(input, &binNodes);
 
   // write out node IDs
   for (int i = startOne; i < numNodes+startOne; i++) 
     fprintf(output,"\tnode\n\t[\n\tid %d\n\t]\n", i);
 
-  while (1) { // throw away everything until get to "edge" declaration
-    if(feof(input)) fatal("no edges to read in input file");
-
-    fscanf(input, "%s", strng); // read in string from file
-
-    if(strncmp(strng, "edge", 4) == 0) 
-      break; // stop when read in first "edge"
-  }
-
-  int source; // hold copy of current endpoints
-  int target; 
-
-  while(!feof(input)) { // read in rest of file
-    for (int i = 0; i < 3; i++)
-      fscanf(input, "%s", strng); // read in '[ source' and source number
-
-    source = atoi(strng); // source of current edge
-
-    for (int i = 0; i < 2; i++)
-      fscanf(input, "%s", strng); // read in 'target' and target number
+  while (binary && readBinaryEdge(input, &source, &target, &binWeight))
+    if(weightValue(binWeight) > minWt-TOL) { // kept edges with their quantised weights
+      fprintf(output, "\tedge\n\t[\n\tsource %d\n\ttarget %d\n\tweight %f\n\t]\n", source, target, weightValue(binWeight));
+      numKept++;
+    }
 
-    target = atoi(strng); // target of current edge
+  for (long int e = 0; e < numFramed; e++) // edges are already in memory
+    if(framedEdge[e].weight > minWt-TOL) {
+      fprintf(output, "\tedge\n\t[\n\tsource %d\n\ttarget %d\n\tweight %f\n\t]\n", framedEdge[e].source, framedEdge[e].target, framedEdge[e].weight);
+      numKept++;
+    }
 
-    // check for weight, end of file, or another edge
-    fscanf(input, "%s", strng); // read in either 'weight' or ']'
-    float weight;
+  for (int v = 0; mappedGraph && (v < graph.numNodes); v++) // edges of each vertex in turn
+    for (long int e = graph.offset[v]; e < graph.offset[v+1]; e++)
+      if(weightValue(graph.weight[e]) > minWt-TOL) {
+	fprintf(output, "\tedge\n\t[\n\tsource %d\n\ttarget %d\n\tweight %f\n\t]\n", graph.id[v], graph.id[graph.target[e]], weightValue(graph.weight[e]));
+	numKept++;
+      }
 
-    if(strncmp(strng, "weight", 6) == 0) {// check to see if weight specified
-      fscanf(input, "%s", strng); // read in string from file
-      weight = atof(strng);
-      fscanf(input, "%s", strng); // read in ']' from file
-    }
+  if (text)
+    rewindGmlEdges(&gml); // second pass over mapped file
 
-    if(feof(input))
-      fatal("Input file has missing data or improper format");
+  while(text && ((found = nextGmlEdge(&gml, &source, &target, &weight, &hasWeight)) != 0)) {
+    if (found < 0)
+      fatal(gml.error);
 
-    // print out edge if edge is not to be deleted
+    // print out edge if weight is high enough
     if(weight > minWt-TOL) {
       fprintf(output, "\tedge\n\t[\n\tsource %d\n\ttarget %d\n\tweight %f\n\t]\n", source, target, weight);
       numKept++;
-      //cout << source << ", " << target << endl;
     }
-
-    fscanf(input,"%s", strng); // read in either 'edge' or final ']'
-
-    if(strncmp(strng, "]", 1) == 0) // end of file
-      break;
   }
 
   fprintf(output,"]\n"); // write out final bracket
 
-  fclose(input);
+  if (binary)
+    fclose(input);
+  if (text)
+    closeGml(&gml);
+  if (mappedGraph)
+    unmapGraph(&graph);
   fclose(output);
+  free(framedEdge); // NULL unless input was framed
+  delete [] weights;
+  delete [] floatWts;
 
 
 
@@ -16,6 +16,10 @@
 #include <string.h>
 #include <algorithm>
 #include "timer.h"
+#include "weights.h"
+#include "frames.h"
+#include "gmlscan.h"
+#include "graphfile.h"
 
 
 const int QUIET = 1;  // set to one to eliminate output to screen
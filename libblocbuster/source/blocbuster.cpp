@@ -0,0 +1,341 @@
+/****************************************************************************
+*
+*	blocbuster.cpp:	Genotype encoding, CCC sweeps, connected components
+*                       and carrier counts on buffers in memory.
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include "blocbuster.h"
+#include "genotypes.h"
+#include "tile.h"
+
+using namespace std;
+
+GenotypeMatrix::GenotypeMatrix()
+{
+  numInd = 0;
+  numSnps = 0;
+  data = NULL;
+  allele = NULL;
+  freq.f[0] = freq.f[1] = NULL;
+  error[0] = '\0';
+}
+
+
+GenotypeMatrix::~GenotypeMatrix()
+{
+  clear();
+}
+
+
+void GenotypeMatrix::clear()
+{
+  if (data != NULL) {
+    for (int i = 0; i < numSnps; i++)
+      delete [] data[i];
+    delete [] data;
+  }
+
+  if (allele != NULL)
+    delete [] allele;
+
+  for (int j = 0; j < 2; j++)
+    if (freq.f[j] != NULL)
+      free(freq.f[j]);
+
+  numInd = 0;
+  numSnps = 0;
+  data = NULL;
+  allele = NULL;
+  freq.f[0] = freq.f[1] = NULL;
+}
+
+
+int GenotypeMatrix::setError(const char *message)
+{
+  sprintf(error, "%.199s", message);
+  clear();
+  return 0;
+}
+
+
+int GenotypeMatrix::load(const char *buffer, long int length, int numInd, int numSnps, int numHeadRows, int numHeadCols, int rowsAreSnps)
+{
+  clear();
+
+  if ((numInd < 1) || (numSnps < 1) || (numInd > MAX_NUM_INDIVIDUALS) || (numSnps > MAX_NUM_SNPS))
+    return setError("Invalid number of individuals or SNPs");
+
+  this->numInd = numInd;
+  this->numSnps = numSnps;
+
+  if (((data = new char*[numSnps]) == NULL) || ((allele = new char[numSnps][2]) == NULL))
+    fatal("memory not allocated");
+
+  for (int i = 0; i < numSnps; i++) {
+    if ((data[i] = new char[numInd]) == NULL)
+      fatal("memory not allocated");
+    allele[i][0] = allele[i][1] = '0'; // no alleles found yet
+  }
+
+  GenotypeLayout layout = {numInd, numSnps, numHeadRows, numHeadCols, rowsAreSnps};
+  char reason[200]; // reason the text couldn't be read
+
+  if (!findAlleles(buffer, length, &layout, allele, reason))
+    return setError(reason);
+
+  sortAlleles(allele, numSnps);
+
+  if (!encodeGenotypes(buffer, length, &layout, allele, data, reason))
+    return setError(reason);
+
+  findFreq();
+  return 1;
+}
+
+
+int GenotypeMatrix::loadCodes(const char *codes, int numInd, int numSnps)
+{
+  clear();
+
+  if ((numInd < 1) || (numSnps < 1) || (numInd > MAX_NUM_INDIVIDUALS) || (numSnps > MAX_NUM_SNPS))
+    return setError("Invalid number of individuals or SNPs");
+
+  this->numInd = numInd;
+  this->numSnps = numSnps;
+
+  if (((data = new char*[numSnps]) == NULL) || ((allele = new char[numSnps][2]) == NULL))
+    fatal("memory not allocated");
+
+  for (int i = 0; i < numSnps; i++) {
+    if ((data[i] = new char[numInd]) == NULL)
+      fatal("memory not allocated");
+    allele[i][0] = '0'; // alleles are unknown
+    allele[i][1] = '0';
+  }
+
+  for (int i = 0; i < numSnps; i++)
+    for (int j = 0; j < numInd; j++) {
+      char code = codes[(long int)i * numInd + j];
+      if ((code < 0) || (code > 3))
+	return setError("Invalid genotype code");
+      data[i][j] = code;
+    }
+
+  findFreq();
+  return 1;
+}
+
+
+void GenotypeMatrix::findFreq()
+{
+  for (int j = 0; j < 2; j++)
+    freq.f[j] = (double*)alignedAlloc(numSnps * sizeof(double));
+
+  for (int i = 0; i < numSnps; i++) {
+    double f[2]; // frequency of each allele
+
+    alleleFreq(data[i], numInd, f);
+    for (int j = 0; j < 2; j++)
+      freq.f[j][i] = 1 - (f[j] / FREQWT); // frequency factor
+  }
+}
+
+
+const char *GenotypeMatrix::getError() { return error; }
+int GenotypeMatrix::getNumInd() { return numInd; }
+int GenotypeMatrix::getNumSnps() { return numSnps; }
+const char *GenotypeMatrix::getRow(int snp) { return data[snp]; }
+char GenotypeMatrix::getAllele(int snp, int high) { return allele[snp][high ? 1 : 0]; }
+const FreqVec *GenotypeMatrix::getFreq() { return &freq; }
+
+
+CccEngine::CccEngine(GenotypeMatrix *matrix)
+{
+  int numSnps = matrix->getNumSnps();
+  float maxFrac = SPARSE ? SPARSE_FRAC : -1.0; // negative to keep all rows dense
+
+  this->matrix = matrix;
+  maxValue = 0.0;
+
+  if ((snp = new SparseSnp[numSnps]) == NULL)
+    fatal("memory not allocated");
+
+  for (int i = 0; i < numSnps; i++) // dense rows stay in matrix
+    makeSparse(matrix->getRow(i), matrix->getNumInd(), maxFrac, &snp[i]);
+}
+
+
+CccEngine::~CccEngine()
+{
+  for (int i = 0; i < matrix->getNumSnps(); i++)
+    freeSparse(&snp[i]);
+  delete [] snp;
+}
+
+
+long int CccEngine::sweep(float thresh, EdgeCallback callback, void *user)
+{
+  int numInd = matrix->getNumInd();
+  int numSnps = matrix->getNumSnps();
+  const FreqVec *freq = matrix->getFreq();
+  long int numEdges = 0; // edges passed to callback
+  PairTile tile; // arrays for a tile of pairs that share their first SNP
+
+  thresh = thresh / 4.5; // unscaled, as values are compared in ccc
+  maxValue = 0.0;
+  allocTile(&tile);
+
+  for (int i = 0; i < numSnps; i++) // upper diagonal only
+    for (int tileStart = i + 1; tileStart < numSnps; tileStart += PAIR_BLOCK) {
+      int tileSize = numSnps - tileStart; // number of pairs in this tile
+      if (tileSize > PAIR_BLOCK)
+	tileSize = PAIR_BLOCK;
+
+      for (int b = 0; b < tileSize; b++) {
+	int j = tileStart + b;
+	int count[4][4]; // number of individuals with each relationship
+
+	pairTally(count, &snp[i], matrix->getRow(i), &snp[j], matrix->getRow(j), numInd);
+	setTally(&tile, b, count);
+      }
+
+      tileProducts(&tile, tileSize, freq, i, freq, tileStart);
+      finaliseTile(&tile, tileSize);
+
+      for (int b = 0; b < tileSize; b++) {
+	int j = tileStart + b;
+
+	if (tile.max[b] > maxValue)
+	  maxValue = tile.max[b];
+
+	if (!TWONODE) { // just one possible edge
+	  if (tile.max[b] > thresh - TOL) {
+	    callback(i+1, j+1, tile.max[b] * 4.5, user);
+	    numEdges++;
+	  }
+	  continue;
+	}
+
+	// endpoints of the ll, lh, hl and hh edges
+	int source[4] = {i+1, i+1, i+numSnps+1, i+numSnps+1};
+	int target[4] = {j+1, j+numSnps+1, j+1, j+numSnps+1};
+
+	for (int r = 0; r < 4; r++)
+	  if (tile.value[r][b] > thresh - TOL) {
+	    callback(source[r], target[r], tile.value[r][b] * 4.5, user);
+	    numEdges++;
+	  }
+      }
+    }
+
+  freeTile(&tile);
+  return numEdges;
+}
+
+
+float CccEngine::getMaxValue() { return maxValue * 4.5; }
+
+
+ComponentFinder::ComponentFinder(int numNodes)
+{
+  allocUnionFind(&uf, numNodes);
+  numEdges = 0;
+}
+
+
+ComponentFinder::~ComponentFinder()
+{
+  freeUnionFind(&uf);
+}
+
+
+void ComponentFinder::addEdge(int source, int target)
+{
+  unionEdge(&uf, source, target);
+  numEdges++;
+}
+
+
+long int ComponentFinder::getNumEdges() { return numEdges; }
+
+
+int ComponentFinder::getClusters(int *clusterNum)
+{
+  return labelComponents(&uf, clusterNum);
+}
+
+
+void ComponentFinder::addCallback(int source, int target, float weight, void *finder)
+{
+  ((ComponentFinder*)finder)->addEdge(source, target);
+}
+
+
+CarrierCounter::CarrierCounter(const int *clusterNum, int numNodes)
+{
+  this->numNodes = numNodes;
+  numClusters = 0;
+
+  for (int i = 0; i < numNodes; i++) // numbers run from 0 (or 1) to largest
+    if (clusterNum[i] + 1 > numClusters)
+      numClusters = clusterNum[i] + 1;
+
+  if (((first = new int[numClusters + 1]) == NULL) || ((members = new int[numNodes]) == NULL))
+    fatal("memory not allocated");
+
+  for (int c = 0; c <= numClusters; c++)
+    first[c] = 0;
+
+  for (int i = 0; i < numNodes; i++) // count alleles of each cluster
+    if (clusterNum[i] >= 0)
+      first[clusterNum[i] + 1]++;
+
+  for (int c = 0; c < numClusters; c++)
+    first[c+1] += first[c];
+
+  int *fill; // next free place for each cluster
+  if ((fill = new int[numClusters]) == NULL)
+    fatal("memory not allocated");
+  memcpy(fill, first, numClusters * sizeof(int));
+
+  for (int i = 0; i < numNodes; i++) // alleles in increasing order
+    if (clusterNum[i] >= 0)
+      members[fill[clusterNum[i]]++] = i;
+
+  delete [] fill;
+}
+
+
+CarrierCounter::~CarrierCounter()
+{
+  delete [] first;
+  delete [] members;
+}
+
+
+int CarrierCounter::getNumClusters() { return numClusters; }
+int CarrierCounter::getClusterSize(int cluster) { return first[cluster+1] - first[cluster]; }
+
+
+int CarrierCounter::count(GenotypeMatrix *matrix, int firstInd, int numInd, int *carriers, int *noMissing)
+{
+  int numSnps = matrix->getNumSnps();
+
+  if ((numNodes != 2 * numSnps) || (firstInd < 0) || (firstInd + numInd > matrix->getNumInd()))
+    return 0;
+
+  char **row; // genotype codes of each SNP
+  if ((row = new char*[numSnps]) == NULL)
+    fatal("memory not allocated");
+  for (int i = 0; i < numSnps; i++)
+    row[i] = (char *)matrix->getRow(i);
+
+  countCarriers(row, numSnps, firstInd, numInd, first, members, numClusters, carriers, noMissing);
+
+  delete [] row;
+  return 1;
+}
@@ -0,0 +1,138 @@
+// -------------------------------------------------------------------------
+// blocbuster.h -   Header file for libblocbuster, the BlocBuster steps as
+//                  a library
+//
+// The steps that ccc, bfs and carriers run on files are available here
+// on buffers in memory, so a program can run them many times without
+// writing and parsing intermediate files:
+//
+//   GenotypeMatrix   encodes genotype text as ccc does (codes 0, 1 and 2
+//                    for the number of copies of the allele that is
+//                    highest alphabetically, 3 for missing) and finds the
+//                    frequency factors of each allele
+//   CccEngine        evaluates every pair of SNPs and passes each edge
+//                    of the ccc network to a callback, in the order ccc
+//                    prints them
+//   ComponentFinder  finds connected components from edges as they are
+//                    passed in, numbered as in the .bfs files of bfs
+//   CarrierCounter   counts the individuals that carry every allele of
+//                    each cluster, as carriers does
+//
+// Node ids run from 1 to 2 * numSnps, as in the .gml files of ccc: node
+// i is the lowest allele of SNP i and node i + numSnps the highest.
+// The constants in ccc's 'bloc.h' apply (TWONODE, FREQWT, SPARSE, ...).
+// Errors in the input are returned rather than ending the program, but
+// running out of memory is still fatal.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _BLOCBUSTER_H
+#define _BLOCBUSTER_H
+
+#include "bloc.h"
+#include "sparse.h"
+#include "components.h"
+
+// called for each edge with node ids from one and the CCC value
+typedef void (*EdgeCallback)(int source, int target, float weight, void *user);
+
+class GenotypeMatrix
+{
+ public:
+  GenotypeMatrix(); // empty matrix
+  ~GenotypeMatrix(); // destructor
+
+  // read genotypes from text in the formats accepted by ccc, with a row
+  // for each SNP if rowsAreSnps is 1 or for each individual if it is 0,
+  // return 1 if successful and 0 (see getError) if not
+  int load(const char *buffer, long int length, int numInd, int numSnps, int numHeadRows, int numHeadCols, int rowsAreSnps = ROWS_R_SNPS);
+
+  // take genotype codes already found, one row of numInd codes per SNP,
+  // return 1 if successful
+  int loadCodes(const char *codes, int numInd, int numSnps);
+
+  const char *getError(); // reason the last load failed
+  int getNumInd(); // number of individuals
+  int getNumSnps(); // number of SNPs
+  const char *getRow(int snp); // genotype codes of SNP (from zero)
+  char getAllele(int snp, int high); // lowest (0) or highest (1) allele of SNP
+  const FreqVec *getFreq(); // frequency factors of both alleles of every SNP
+
+ private:
+  void clear(); // release memory
+  int setError(const char *message); // record reason for failure, return 0
+  void findFreq(); // frequency factors from genotype codes
+
+  int numInd; // number of individuals
+  int numSnps; // number of SNPs
+  char **data; // genotype codes of each SNP
+  char (*allele)[2]; // alleles of each SNP in alphabetical order
+  FreqVec freq; // frequency factors
+  char error[200]; // reason the last load failed
+};
+
+class CccEngine
+{
+ public:
+  CccEngine(GenotypeMatrix *matrix); // matrix must outlive engine
+  ~CccEngine(); // destructor
+
+  // evaluate every pair of SNPs and pass each edge with a value of at
+  // least thresh to callback, return number of edges
+  long int sweep(float thresh, EdgeCallback callback, void *user);
+
+  float getMaxValue(); // largest CCC value of last sweep
+
+ private:
+  GenotypeMatrix *matrix; // genotypes and frequency factors
+  SparseSnp *snp; // counts and lists of rare individuals for each SNP
+  float maxValue; // largest CCC value of last sweep
+};
+
+class ComponentFinder
+{
+ public:
+  ComponentFinder(int numNodes); // each node on its own
+  ~ComponentFinder(); // destructor
+
+  void addEdge(int source, int target); // node ids from one
+  long int getNumEdges(); // number of edges added
+
+  // cluster number of each node as in .bfs files (-1 for singletons),
+  // return number of clusters
+  int getClusters(int *clusterNum);
+
+  // pass to CccEngine::sweep with a ComponentFinder as user data
+  static void addCallback(int source, int target, float weight, void *finder);
+
+ private:
+  UnionFind uf; // components so far
+  long int numEdges; // number of edges added
+};
+
+class CarrierCounter
+{
+ public:
+  // clusters from cluster numbers of the 2 * numSnps allele nodes (from
+  // getClusters or a .bfs file)
+  CarrierCounter(const int *clusterNum, int numNodes);
+  ~CarrierCounter(); // destructor
+
+  int getNumClusters(); // number of clusters
+  int getClusterSize(int cluster); // number of alleles in cluster
+
+  // for numInd individuals starting with firstInd, count those with
+  // every allele of each cluster and those with no missing genotypes
+  // for the cluster, return 1 if matrix matches clusters
+  int count(GenotypeMatrix *matrix, int firstInd, int numInd, int *carriers, int *noMissing);
+
+ private:
+  int numNodes; // number of allele nodes
+  int numClusters; // number of clusters
+  int *first; // index in members of first allele of each cluster
+  int *members; // allele nodes of each cluster (from zero), cluster by cluster
+};
+
+#endif
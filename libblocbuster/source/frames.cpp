@@ -0,0 +1,364 @@
+/****************************************************************************
+*
+*	frames.cpp:	Writing and reading edge files compressed in
+*                       independent frames, with an index for random
+*                       access (see frames.h).
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include "frames.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+const int FRAME_TEXT_BYTES = 96; // room for one edge as .gml text
+const int FRAME_TRAILER_BYTES = 24; // number of frames, index offset and magic
+const int FRAME_INDEX_BYTES = 12; // offset and number of edges of a frame
+
+
+static int allocFrames(FrameWriter *fw, FILE *output, int binary) // return 0 if memory not allocated
+{
+  fw->output = output;
+  fw->binary = binary;
+  fw->offset = 0;
+  fw->numEdges = 0;
+  fw->rawBytes = 0;
+  fw->rawCap = (long int)FRAME_EDGES * (binary ? BINARY_EDGE_BYTES : FRAME_TEXT_BYTES);
+  fw->compCap = compressBound(fw->rawCap);
+  fw->numFrames = 0;
+  fw->capFrames = 1024;
+
+  fw->raw = (char *)malloc(fw->rawCap);
+  fw->comp = (unsigned char *)malloc(fw->compCap);
+  fw->frameOffset = (long int *)malloc(fw->capFrames * sizeof(long int));
+  fw->frameEdges = (int *)malloc(fw->capFrames * sizeof(int));
+
+  return (fw->raw != NULL) && (fw->comp != NULL) && (fw->frameOffset != NULL) && (fw->frameEdges != NULL);
+}
+
+
+static int addToIndex(FrameWriter *fw, long int offset, int numEdges) // return 0 if memory not allocated
+{
+  if (fw->numFrames == fw->capFrames) { // double the index
+    fw->capFrames *= 2;
+    fw->frameOffset = (long int *)realloc(fw->frameOffset, fw->capFrames * sizeof(long int));
+    fw->frameEdges = (int *)realloc(fw->frameEdges, fw->capFrames * sizeof(int));
+    if ((fw->frameOffset == NULL) || (fw->frameEdges == NULL))
+      return 0;
+  }
+
+  fw->frameOffset[fw->numFrames] = offset;
+  fw->frameEdges[fw->numFrames] = numEdges;
+  fw->numFrames++;
+  return 1;
+}
+
+
+int startFrames(FrameWriter *fw, FILE *output, int numNodes, int binary)
+{
+  if (!allocFrames(fw, output, binary))
+    return 0;
+
+  int frameEdges = FRAME_EDGES;
+
+  if ((fwrite(FRAME_MAGIC, 1, 8, output) != 8) || (fwrite(&numNodes, sizeof(int), 1, output) != 1) || (fwrite(&binary, sizeof(int), 1, output) != 1) || (fwrite(&frameEdges, sizeof(int), 1, output) != 1))
+    return 0;
+
+  fw->offset = FRAME_HEAD_BYTES;
+  return 1;
+}
+
+
+int resumeFrames(FrameWriter *fw, FILE *output, long int offset)
+{
+  int numNodes, binary;
+
+  rewind(output);
+  if (!readFrameHead(output, &numNodes, &binary) || !allocFrames(fw, output, binary))
+    return 0;
+
+  long int pos = FRAME_HEAD_BYTES; // start of next frame
+
+  while (pos < offset) { // follow frame headers to rebuild index
+    int head[3]; // edges, raw bytes and compressed bytes
+
+    if ((fseek(output, pos, SEEK_SET) != 0) || (fread(head, sizeof(int), 3, output) != 3) || !addToIndex(fw, pos, head[0]))
+      return 0;
+
+    pos += 3 * sizeof(int) + head[2];
+  }
+
+  if ((pos != offset) || (fseek(output, offset, SEEK_SET) != 0))
+    return 0; // offset isn't at the end of a frame
+
+  fw->offset = offset;
+  return 1;
+}
+
+
+int frameEdge(FrameWriter *fw, int source, int target, float weight)
+{
+  char *next = fw->raw + fw->rawBytes; // end of current frame
+
+  if (fw->binary) {
+    unsigned short q = quantiseWeight(weight);
+    memcpy(next, &source, sizeof(int));
+    memcpy(next + sizeof(int), &target, sizeof(int));
+    memcpy(next + 2 * sizeof(int), &q, sizeof(unsigned short));
+    fw->rawBytes += BINARY_EDGE_BYTES;
+  }
+
+  else // same text as the .gml file
+    fw->rawBytes += snprintf(next, FRAME_TEXT_BYTES, "\tedge\n\t[\n\tsource %d\n\ttarget %d\n\tweight %f\n\t]\n", source, target, weight);
+
+  if (++fw->numEdges == FRAME_EDGES)
+    return flushFrame(fw);
+
+  return 1;
+}
+
+
+int flushFrame(FrameWriter *fw)
+{
+  if (fw->numEdges == 0)
+    return 1; // nothing to write
+
+  uLongf compBytes = fw->compCap;
+  if (compress2(fw->comp, &compBytes, (const Bytef *)fw->raw, fw->rawBytes, FRAME_LEVEL) != Z_OK)
+    return 0;
+
+  int head[3] = {fw->numEdges, (int)fw->rawBytes, (int)compBytes}; // frame header
+
+  if (!addToIndex(fw, fw->offset, fw->numEdges))
+    return 0;
+
+  if ((fwrite(head, sizeof(int), 3, fw->output) != 3) || (fwrite(fw->comp, 1, compBytes, fw->output) != compBytes))
+    return 0;
+
+  fw->offset += 3 * sizeof(int) + compBytes;
+  fw->numEdges = 0;
+  fw->rawBytes = 0;
+  return 1;
+}
+
+
+int finishFrames(FrameWriter *fw)
+{
+  int ok = flushFrame(fw);
+  long int indexOffset = fw->offset; // index follows last frame
+
+  for (long int f = 0; ok && (f < fw->numFrames); f++)
+    ok = (fwrite(&fw->frameOffset[f], sizeof(long int), 1, fw->output) == 1) && (fwrite(&fw->frameEdges[f], sizeof(int), 1, fw->output) == 1);
+
+  ok = ok && (fwrite(&fw->numFrames, sizeof(long int), 1, fw->output) == 1) && (fwrite(&indexOffset, sizeof(long int), 1, fw->output) == 1) && (fwrite(FRAME_INDEX_MAGIC, 1, 8, fw->output) == 8);
+
+  fw->offset += fw->numFrames * FRAME_INDEX_BYTES + FRAME_TRAILER_BYTES;
+
+  free(fw->raw);
+  free(fw->comp);
+  free(fw->frameOffset);
+  free(fw->frameEdges);
+  return ok;
+}
+
+
+int readFrameHead(FILE *input, int *numNodes, int *binary)
+{
+  char magic[8];
+  int frameEdges;
+
+  if ((fread(magic, 1, 8, input) == 8) && (memcmp(magic, FRAME_MAGIC, 8) == 0) && (fread(numNodes, sizeof(int), 1, input) == 1) && (fread(binary, sizeof(int), 1, input) == 1) && (fread(&frameEdges, sizeof(int), 1, input) == 1))
+    return 1;
+
+  rewind(input);
+  return 0;
+}
+
+
+static int parseFrame(const char *raw, long int rawBytes, int binary, FramedEdge *edges, int numEdges) // return 1 if numEdges edges found
+{
+  if (binary) {
+    if (rawBytes != (long int)numEdges * BINARY_EDGE_BYTES)
+      return 0;
+
+    for (int e = 0; e < numEdges; e++) {
+      const char *rec = raw + (long int)e * BINARY_EDGE_BYTES; // record of this edge
+      unsigned short q;
+      memcpy(&edges[e].source, rec, sizeof(int));
+      memcpy(&edges[e].target, rec + sizeof(int), sizeof(int));
+      memcpy(&q, rec + 2 * sizeof(int), sizeof(unsigned short));
+      edges[e].weight = weightValue(q);
+    }
+
+    return 1;
+  }
+
+  int e = 0; // edges found so far
+  const char *p = raw; // next character to read
+  const char *end = raw + rawBytes;
+
+  while ((p < end) && (e < numEdges)) { // each edge is 'edge [ source s target t weight w ]'
+    const char *next;
+
+    if ((next = strstr(p, "source")) == NULL)
+      return 0;
+    edges[e].source = (int)strtol(next + 6, (char **)&p, 10);
+
+    if ((next = strstr(p, "target")) == NULL)
+      return 0;
+    edges[e].target = (int)strtol(next + 6, (char **)&p, 10);
+
+    while ((*p == ' ') || (*p == '\t') || (*p == '\n'))
+      p++;
+
+    edges[e].weight = 1.0; // weight is optional
+    if (strncmp(p, "weight", 6) == 0)
+      edges[e].weight = strtof(p + 6, (char **)&p);
+
+    if ((next = strchr(p, ']')) == NULL)
+      return 0;
+    p = next + 1;
+    e++;
+  }
+
+  return (e == numEdges);
+}
+
+
+// grow the arrays of frame offsets and first edges to hold cap frames,
+// return 0 (leaving both as they were) if memory not allocated
+static int growFrames(long int **frameOffset, long int **firstEdge, long int cap)
+{
+  long int *offset = (long int *)realloc(*frameOffset, (cap + 1) * sizeof(long int));
+  if (offset == NULL)
+    return 0;
+  *frameOffset = offset;
+
+  long int *first = (long int *)realloc(*firstEdge, (cap + 1) * sizeof(long int));
+  if (first == NULL)
+    return 0;
+  *firstEdge = first;
+
+  return 1;
+}
+
+
+// release the frame arrays of readFramedEdges(), return -1 for its caller
+static long int dropFrames(long int *frameOffset, long int *firstEdge)
+{
+  free(frameOffset);
+  free(firstEdge);
+  return -1;
+}
+
+
+long int readFramedEdges(FILE *input, FramedEdge **edges)
+{
+  int fd = fileno(input); // frames are read with pread so threads don't share a position
+  int numNodes, binary;
+  char head[FRAME_HEAD_BYTES];
+
+  if ((pread(fd, head, FRAME_HEAD_BYTES, 0) != FRAME_HEAD_BYTES) || (memcmp(head, FRAME_MAGIC, 8) != 0))
+    return -1;
+  memcpy(&numNodes, head + 8, sizeof(int));
+  memcpy(&binary, head + 12, sizeof(int));
+
+  long int numFrames = 0; // frames in file
+  long int capFrames = 1024;
+  long int *frameOffset = NULL; // offset of each frame in file
+  long int *firstEdge = NULL; // index in edges of first edge of each frame
+  if (!growFrames(&frameOffset, &firstEdge, capFrames))
+    return dropFrames(frameOffset, firstEdge);
+
+  // find frames through the index trailer, or by following frame headers
+  char trailer[FRAME_TRAILER_BYTES];
+  long int indexOffset = -1;
+  long int fileBytes = lseek(fd, 0, SEEK_END);
+
+  if ((fileBytes >= FRAME_HEAD_BYTES + FRAME_TRAILER_BYTES) && (pread(fd, trailer, FRAME_TRAILER_BYTES, fileBytes - FRAME_TRAILER_BYTES) == FRAME_TRAILER_BYTES) && (memcmp(trailer + 16, FRAME_INDEX_MAGIC, 8) == 0)) {
+    memcpy(&numFrames, trailer, sizeof(long int));
+    memcpy(&indexOffset, trailer + 8, sizeof(long int));
+  }
+
+  if (indexOffset >= 0) {
+    capFrames = numFrames;
+    if (!growFrames(&frameOffset, &firstEdge, capFrames))
+      return dropFrames(frameOffset, firstEdge);
+
+    firstEdge[0] = 0;
+    for (long int f = 0; f < numFrames; f++) {
+      char entry[FRAME_INDEX_BYTES];
+      int frameEdges;
+
+      if (pread(fd, entry, FRAME_INDEX_BYTES, indexOffset + f * FRAME_INDEX_BYTES) != FRAME_INDEX_BYTES)
+	return dropFrames(frameOffset, firstEdge);
+      memcpy(&frameOffset[f], entry, sizeof(long int));
+      memcpy(&frameEdges, entry + sizeof(long int), sizeof(int));
+      firstEdge[f+1] = firstEdge[f] + frameEdges;
+    }
+  }
+
+  else { // interrupted run, so follow headers up to the last complete frame
+    long int pos = FRAME_HEAD_BYTES;
+    int frameHead[3]; // edges, raw bytes and compressed bytes
+
+    firstEdge[0] = 0;
+    while ((pread(fd, frameHead, sizeof(frameHead), pos) == sizeof(frameHead)) && (pos + (long int)sizeof(frameHead) + frameHead[2] <= fileBytes)) {
+      if (numFrames == capFrames) {
+	capFrames *= 2;
+	if (!growFrames(&frameOffset, &firstEdge, capFrames))
+	  return dropFrames(frameOffset, firstEdge);
+      }
+
+      frameOffset[numFrames] = pos;
+      firstEdge[numFrames+1] = firstEdge[numFrames] + frameHead[0];
+      numFrames++;
+      pos += sizeof(frameHead) + frameHead[2];
+    }
+  }
+
+  long int numEdges = firstEdge[numFrames];
+  if ((*edges = (FramedEdge *)malloc((numEdges + 1) * sizeof(FramedEdge))) == NULL)
+    return dropFrames(frameOffset, firstEdge);
+
+  int damaged = 0; // set if any thread finds a bad frame
+
+  #pragma omp parallel for schedule(dynamic) reduction(||:damaged)
+  for (long int f = 0; f < numFrames; f++) {
+    int frameHead[3]; // edges, raw bytes and compressed bytes
+
+    if (pread(fd, frameHead, sizeof(frameHead), frameOffset[f]) != sizeof(frameHead)) {
+      damaged = 1;
+      continue;
+    }
+
+    unsigned char *comp = (unsigned char *)malloc(frameHead[2]);
+    char *raw = (char *)malloc(frameHead[1] + 1);
+    uLongf rawBytes = frameHead[1];
+
+    if ((comp == NULL) || (raw == NULL) || (frameHead[0] != firstEdge[f+1] - firstEdge[f]) || (pread(fd, comp, frameHead[2], frameOffset[f] + sizeof(frameHead)) != frameHead[2]) || (uncompress((Bytef *)raw, &rawBytes, comp, frameHead[2]) != Z_OK) || (rawBytes != (uLongf)frameHead[1]))
+      damaged = 1;
+
+    else {
+      raw[rawBytes] = '\0'; // text is parsed as a string
+      if (!parseFrame(raw, rawBytes, binary, *edges + firstEdge[f], frameHead[0]))
+	damaged = 1;
+    }
+
+    free(comp);
+    free(raw);
+  }
+
+  dropFrames(frameOffset, firstEdge);
+
+  if (damaged) {
+    free(*edges);
+    return -1;
+  }
+
+  return numEdges;
+}
@@ -0,0 +1,88 @@
+// -------------------------------------------------------------------------
+// frames.h -   Header file for compressed edge files with random access
+//
+// A framed edge file written by 'ccc --framed' holds the edges in
+// frames of up to FRAME_EDGES edges, each compressed on its own with
+// zlib.  The edges of a frame are either .gml text, exactly as ccc
+// prints them, or the 10-byte binary records of weights.h.  The file
+// starts with FRAME_MAGIC, the number of nodes (nodes are numbered from
+// 1), whether frames are binary and the number of edges in a full
+// frame (ints).  Each frame starts with its number of edges, its size
+// before and after compression (ints).  An index trailer follows the
+// last frame: the offset of each frame (long int) and its number of
+// edges (int), then the number of frames and the offset of the index
+// (long ints) and FRAME_INDEX_MAGIC.  Values are in the byte order of
+// the machine.
+//
+// Since frames don't depend on each other, readers find them through
+// the index and decompress and parse them in parallel.  A file without
+// a trailer (from an interrupted run) is read by following the frame
+// headers from the start.
+//
+// ccc, keepHi and bfs all compile this one copy, from libblocbuster.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _FRAMES_H
+#define _FRAMES_H
+
+#include <stdio.h>
+#include "weights.h"
+
+const char FRAME_MAGIC[8] = {'C', 'C', 'C', 'F', 'R', 'A', 'M', '1'}; // start of framed edge file
+const char FRAME_INDEX_MAGIC[8] = {'C', 'C', 'C', 'F', 'I', 'D', 'X', '1'}; // end of index trailer
+const int FRAME_EDGES = 65536; // edges in a full frame
+const int FRAME_HEAD_BYTES = 20; // magic, nodes, binary and edges per frame
+const int FRAME_LEVEL = 6; // zlib compression level (1 fastest, 9 smallest)
+
+struct FrameWriter
+{
+  FILE *output; // framed edge file
+  int binary; // 1 if frames hold binary records, 0 for .gml text (Boolean)
+  long int offset; // bytes written so far (output may be a pipe)
+  int numEdges; // edges in current frame
+  char *raw; // current frame before compression
+  long int rawBytes; // bytes used in raw
+  long int rawCap; // bytes allocated for raw
+  unsigned char *comp; // compressed frame
+  long int compCap; // bytes allocated for comp
+  long int numFrames; // frames written so far
+  long int capFrames; // entries allocated in index
+  long int *frameOffset; // offset of each frame
+  int *frameEdges; // number of edges in each frame
+};
+
+struct FramedEdge
+{
+  int source; // node ids from 1
+  int target;
+  float weight;
+};
+
+// write header of a new file, return 1 if successful
+int startFrames(FrameWriter *fw, FILE *output, int numNodes, int binary);
+
+// pick up a file truncated to offset after its last complete frame,
+// rebuilding the index, return 1 if successful
+int resumeFrames(FrameWriter *fw, FILE *output, long int offset);
+
+// add an edge to the current frame, writing the frame when full
+int frameEdge(FrameWriter *fw, int source, int target, float weight);
+
+// compress and write the current frame if it has any edges
+int flushFrame(FrameWriter *fw);
+
+// write the last frame and the index trailer, free memory
+int finishFrames(FrameWriter *fw);
+
+// return 1 if input is a framed edge file (and read its header), or 0
+// and rewind if not
+int readFrameHead(FILE *input, int *numNodes, int *binary);
+
+// decompress and parse every frame of the file in parallel, in the order
+// they were written, return number of edges or -1 if the file is damaged
+long int readFramedEdges(FILE *input, FramedEdge **edges);
+
+#endif
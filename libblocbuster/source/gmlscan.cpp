@@ -0,0 +1,288 @@
+/****************************************************************************
+*
+*	gmlscan.cpp:	Reading .gml network files mapped into memory
+*                       (see gmlscan.h).
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include "gmlscan.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+const int GML_TOKEN_BYTES = 64; // longest number given to strtod
+const int GML_READ_BYTES = 1 << 20; // bytes read at a time from a pipe
+
+
+int gmlFail(GmlScanner *gs, const char *message) // record reason for failure, return 0
+{
+  strncpy(gs->error, message, sizeof(gs->error) - 1);
+  gs->error[sizeof(gs->error) - 1] = '\0';
+  return 0;
+}
+
+
+int gmlEdgeFail(GmlScanner *gs, const char *message) // record reason edge is not well formed, return -1
+{
+  gmlFail(gs, message);
+  return -1;
+}
+
+
+inline int isSpace(char c) // white space as fscanf sees it
+{
+  return (c == ' ') || (c == '\n') || (c == '\t') || (c == '\r') || (c == '\v') || (c == '\f');
+}
+
+
+// find next token, return its length (0 at end of file) and set *token
+inline long int nextToken(GmlScanner *gs, const char **token)
+{
+  const char *p = gs->pos;
+  while ((p < gs->end) && isSpace(*p))
+    p++;
+  *token = p;
+  while ((p < gs->end) && !isSpace(*p))
+    p++;
+  gs->pos = p;
+  return p - *token;
+}
+
+
+inline int startsWith(const char *token, long int length, const char *word) // as strncmp(token, word, strlen(word)) == 0
+{
+  long int n = strlen(word);
+  return (length >= n) && (memcmp(token, word, n) == 0);
+}
+
+
+inline int parseInt(const char *token, long int length) // as atoi
+{
+  long int i = 0;
+  int negative = 0;
+  if ((i < length) && ((token[i] == '-') || (token[i] == '+')))
+    negative = (token[i++] == '-');
+
+  int value = 0;
+  while ((i < length) && (token[i] >= '0') && (token[i] <= '9'))
+    value = 10 * value + (token[i++] - '0');
+  return negative ? -value : value;
+}
+
+
+double parseSlow(const char *token, long int length) // as atof, for unusual numbers
+{
+  char buffer[GML_TOKEN_BYTES];
+  if (length >= GML_TOKEN_BYTES)
+    length = GML_TOKEN_BYTES - 1;
+  memcpy(buffer, token, length);
+  buffer[length] = '\0';
+  return strtod(buffer, NULL);
+}
+
+
+inline double parseDouble(const char *token, long int length) // as atof
+{
+  static const double power[16] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+				    1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+  long int i = 0;
+  int negative = 0;
+  if ((i < length) && ((token[i] == '-') || (token[i] == '+')))
+    negative = (token[i++] == '-');
+
+  long int mantissa = 0; // digits without the decimal point
+  int digits = 0; // digits in mantissa
+  int decimals = -1; // digits after the decimal point, -1 before it
+
+  for (; i < length; i++) {
+    if ((token[i] >= '0') && (token[i] <= '9')) {
+      mantissa = 10 * mantissa + (token[i] - '0');
+      digits++;
+      if (decimals >= 0)
+	decimals++;
+    }
+    else if ((token[i] == '.') && (decimals < 0))
+      decimals = 0;
+    else
+      break;
+  }
+
+  // both mantissa and power of ten are exact doubles, so one division
+  // rounds the same way strtod does
+  if ((i < length) || (digits == 0) || (digits > 15))
+    return parseSlow(token, length);
+
+  double value = (decimals > 0) ? mantissa / power[decimals] : (double)mantissa;
+  return negative ? -value : value;
+}
+
+
+int readWhole(GmlScanner *gs, FILE *input) // read input that can't be mapped, return 0 if memory not allocated
+{
+  long int cap = GML_READ_BYTES;
+  gs->size = 0;
+  if ((gs->data = (char *)malloc(cap)) == NULL)
+    return 0;
+
+  long int got;
+  while ((got = fread(gs->data + gs->size, 1, cap - gs->size, input)) > 0)
+    if ((gs->size += got) == cap) {
+      cap *= 2;
+      if ((gs->data = (char *)realloc(gs->data, cap)) == NULL)
+	return 0;
+    }
+
+  return !ferror(input);
+}
+
+
+int openGml(GmlScanner *gs, FILE *input)
+{
+  gs->data = NULL;
+  gs->size = 0;
+  gs->mapped = 0;
+  gs->id = NULL;
+  gs->numNodes = 0;
+  gs->minId = 1000000000;
+  gs->maxId = -1000000000;
+  gs->error[0] = '\0';
+
+  int fd = fileno(input);
+  struct stat info;
+  if (fstat(fd, &info) != 0)
+    return gmlFail(gs, "File could not be opened.");
+
+  if (S_ISREG(info.st_mode) && (info.st_size > 0)) {
+    gs->size = info.st_size;
+    gs->data = (char *)mmap(NULL, gs->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (gs->data == MAP_FAILED)
+      gs->data = NULL;
+    else {
+      gs->mapped = 1;
+      madvise(gs->data, gs->size, MADV_SEQUENTIAL); // read ahead
+    }
+  }
+
+  if (!gs->mapped && !readWhole(gs, input))
+    return gmlFail(gs, "GML file could not be read into memory");
+
+  gs->pos = gs->data;
+  gs->end = gs->data + gs->size;
+
+  const char *token;
+  long int length;
+
+  do { // throw away everything until get to "graph" declaration
+    if ((length = nextToken(gs, &token)) == 0)
+      return gmlFail(gs, "no graph to read in input file");
+  } while (!startsWith(token, length, "graph"));
+
+  int capNodes = 1024;
+  if ((gs->id = (int *)malloc(capNodes * sizeof(int))) == NULL)
+    return gmlFail(gs, "memory not allocated");
+
+  while (1) { // record node ids until get to first "edge" declaration
+    if ((length = nextToken(gs, &token)) == 0)
+      return gmlFail(gs, "no edges to read in input file");
+
+    if (startsWith(token, length, "id")) {
+      length = nextToken(gs, &token); // id value
+      int num = parseInt(token, length);
+
+      if (gs->minId > num) gs->minId = num; // update minimum node number
+      if (gs->maxId < num) gs->maxId = num; // update maximum node number
+
+      if (gs->numNodes == capNodes) { // double the array
+	capNodes *= 2;
+	if ((gs->id = (int *)realloc(gs->id, capNodes * sizeof(int))) == NULL)
+	  return gmlFail(gs, "memory not allocated");
+      }
+      gs->id[gs->numNodes++] = num;
+    }
+
+    if (startsWith(token, length, "edge"))
+      break; // stop when read in first "edge"
+  }
+
+  gs->firstEdge = gs->pos;
+  return 1;
+}
+
+
+int nextGmlEdge(GmlScanner *gs, int *source, int *target, float *weight, int *hasWeight)
+{
+  const char *token;
+  long int length;
+
+  if (gs->pos == NULL) // end of graph already found
+    return 0;
+
+  if (gs->pos != gs->firstEdge) { // read 'edge' or final ']' after previous edge
+    length = nextToken(gs, &token);
+    if ((length == 0) || startsWith(token, length, "]")) {
+      gs->pos = NULL;
+      return 0;
+    }
+    if (!startsWith(token, length, "edge"))
+      return gmlEdgeFail(gs, "No 'edge' declaration");
+  }
+
+  length = nextToken(gs, &token);
+  if (length == 0) { // file ended after "edge"
+    gs->pos = NULL;
+    return 0;
+  }
+  if (!startsWith(token, length, "["))
+    return gmlEdgeFail(gs, "No '[' after edge declaration");
+
+  length = nextToken(gs, &token);
+  if (!startsWith(token, length, "source"))
+    return gmlEdgeFail(gs, "No 'source' declaration");
+  length = nextToken(gs, &token);
+  *source = parseInt(token, length);
+
+  length = nextToken(gs, &token);
+  if (!startsWith(token, length, "target"))
+    return gmlEdgeFail(gs, "No 'target' declaration");
+  length = nextToken(gs, &token);
+  *target = parseInt(token, length);
+
+  *weight = 1.0;
+  *hasWeight = 0;
+  length = nextToken(gs, &token);
+  if (startsWith(token, length, "weight")) { // weight specified
+    length = nextToken(gs, &token);
+    *weight = parseDouble(token, length);
+    *hasWeight = 1;
+    length = nextToken(gs, &token);
+  }
+
+  if (!startsWith(token, length, "]"))
+    return gmlEdgeFail(gs, "No ']' after edge declaration");
+
+  return 1;
+}
+
+
+void rewindGmlEdges(GmlScanner *gs)
+{
+  gs->pos = gs->firstEdge;
+}
+
+
+void closeGml(GmlScanner *gs)
+{
+  if (gs->mapped)
+    munmap(gs->data, gs->size);
+  else
+    free(gs->data);
+  free(gs->id);
+  gs->data = NULL;
+  gs->id = NULL;
+}
@@ -0,0 +1,62 @@
+// -------------------------------------------------------------------------
+// gmlscan.h -   Header file for fast reading of .gml network files
+//
+// The whole file is mapped into memory and read once, token by token,
+// without fscanf.  Tokens are runs of characters other than white space,
+// as fscanf("%s") would read them, and keywords are matched on their
+// first letters as before.  Everything before the first token starting
+// with "graph" is skipped.  Node ids are the tokens after "id", up to
+// the first "edge".  Each edge is then
+//
+//     edge [ source s target t weight w ]
+//
+// where the weight is optional, and the graph ends with a "]" or at the
+// end of the file.  Integers are read as atoi would and plain decimals
+// with up to 15 digits are converted exactly as atof would, so the
+// numbers are the same as before; anything else goes through strtod.
+//
+// Input that is not a regular file (a pipe) is read into memory from
+// its current position instead of being mapped.
+//
+// bfs and keepHi both compile this one copy, from libblocbuster.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _GMLSCAN_H
+#define _GMLSCAN_H
+
+#include <stdio.h>
+
+struct GmlScanner
+{
+  char *data; // contents of file
+  long int size; // bytes in data
+  int mapped; // 1 if data is mapped, 0 if read into memory (Boolean)
+  const char *pos; // next character to read
+  const char *end; // one past last character
+  const char *firstEdge; // token after first "edge" declaration
+  int numNodes; // number of node ids
+  int *id; // node ids in order of declaration
+  int minId, maxId; // smallest and largest node id
+  char error[100]; // reason for last failure
+};
+
+// map open file and read its node ids, leaving the scanner at the first
+// edge, return 1 if successful and 0 (see error) if not; input may be
+// closed as soon as this returns
+int openGml(GmlScanner *gs, FILE *input);
+
+// read next edge; weight is set to 1.0 and hasWeight to 0 if the edge
+// has no weight, return 1 for an edge, 0 at the end of the graph and -1
+// (see error) if the edge is not well formed
+int nextGmlEdge(GmlScanner *gs, int *source, int *target, float *weight, int *hasWeight);
+
+// go back to the first edge
+void rewindGmlEdges(GmlScanner *gs);
+
+// unmap file and free memory
+void closeGml(GmlScanner *gs);
+
+#endif
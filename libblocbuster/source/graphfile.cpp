@@ -0,0 +1,164 @@
+/****************************************************************************
+*
+*	graphfile.cpp:	Writing and mapping networks saved as CSR
+*                       arrays (see graphfile.h).
+*
+*                       October 2026
+*
+****************************************************************************/
+
+
+#include "graphfile.h"
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+long int alignGraph(long int bytes) // round up to a multiple of 8 bytes
+{
+  return (bytes + 7) & ~7L;
+}
+
+
+// find where each array starts, return size of file
+long int graphLayout(int numNodes, long int numEdges, long int *idAt, long int *offsetAt, long int *targetAt, long int *weightAt)
+{
+  *idAt = GRAPH_HEAD_BYTES;
+  *offsetAt = alignGraph(*idAt + (long int)numNodes * sizeof(int));
+  *targetAt = alignGraph(*offsetAt + (numNodes + 1L) * sizeof(long int));
+  *weightAt = alignGraph(*targetAt + numEdges * sizeof(int));
+  return *weightAt + numEdges * sizeof(unsigned short);
+}
+
+
+int padGraph(FILE *output, long int *written, long int at) // write zeros up to offset at, return 1 if successful
+{
+  const char zero[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  long int pad = at - *written;
+  *written = at;
+  return (pad == 0) || (fwrite(zero, 1, pad, output) == (size_t)pad);
+}
+
+
+// check in one pass that rows run from 0 to numEdges without going back
+// and that each row's targets are increasing, above its vertex and below
+// numNodes, so the arrays can be indexed without further checks
+static int graphIntact(const GraphFile *gf)
+{
+  if ((gf->offset[0] != 0) || (gf->offset[gf->numNodes] != gf->numEdges))
+    return 0;
+
+  for (int v = 0; v < gf->numNodes; v++) {
+    if (gf->offset[v+1] < gf->offset[v])
+      return 0;
+
+    int prev = v; // targets must be above this
+    for (long int e = gf->offset[v]; e < gf->offset[v+1]; e++) {
+      if ((gf->target[e] <= prev) || (gf->target[e] >= gf->numNodes))
+	return 0;
+      prev = gf->target[e];
+    }
+  }
+
+  return 1;
+}
+
+
+int mapGraph(GraphFile *gf, FILE *input)
+{
+  char head[GRAPH_HEAD_BYTES];
+
+  if ((fread(head, 1, GRAPH_HEAD_BYTES, input) != (size_t)GRAPH_HEAD_BYTES) || (memcmp(head, GRAPH_MAGIC, 8) != 0)) {
+    rewind(input);
+    return 0;
+  }
+  memcpy(&gf->numNodes, head + 8, sizeof(int));
+  memcpy(&gf->twoNode, head + 12, sizeof(int));
+  memcpy(&gf->numEdges, head + 16, sizeof(long int));
+
+  struct stat info;
+  long int idAt, offsetAt, targetAt, weightAt;
+  if ((gf->numNodes < 1) || (gf->numEdges < 0) || (fstat(fileno(input), &info) != 0))
+    return -1;
+  gf->size = graphLayout(gf->numNodes, gf->numEdges, &idAt, &offsetAt, &targetAt, &weightAt);
+  if (info.st_size != gf->size)
+    return -1;
+
+  gf->data = (char *)mmap(NULL, gf->size, PROT_READ, MAP_SHARED, fileno(input), 0);
+  if (gf->data == MAP_FAILED)
+    return -1;
+
+  gf->id = (const int *)(gf->data + idAt);
+  gf->offset = (const long int *)(gf->data + offsetAt);
+  gf->target = (const int *)(gf->data + targetAt);
+  gf->weight = (const unsigned short *)(gf->data + weightAt);
+
+  if (!graphIntact(gf)) {
+    unmapGraph(gf);
+    return -1;
+  }
+
+  return 1;
+}
+
+
+void unmapGraph(GraphFile *gf)
+{
+  munmap(gf->data, gf->size);
+  gf->data = NULL;
+}
+
+
+int writeGraph(const char *fileName, int numNodes, int twoNode, const int *id, const long int *offset, const int *target, const unsigned short *weight)
+{
+  // entries of v above v are the end of its row, as rows are sorted
+  long int *first; // first entry kept in each row
+  if ((first = (long int *)malloc(numNodes * sizeof(long int))) == NULL)
+    return 0;
+
+  FILE *output;
+  if ((output = fopen(fileName, "wb")) == NULL) {
+    free(first);
+    return 0;
+  }
+
+  long int numEdges = 0;
+  for (int v = 0; v < numNodes; v++) {
+    first[v] = std::upper_bound(target + offset[v], target + offset[v+1], v) - target;
+    numEdges += offset[v+1] - first[v];
+  }
+
+  long int idAt, offsetAt, targetAt, weightAt;
+  long int size = graphLayout(numNodes, numEdges, &idAt, &offsetAt, &targetAt, &weightAt);
+  long int written = GRAPH_HEAD_BYTES;
+
+  int ok = (fwrite(GRAPH_MAGIC, 1, 8, output) == 8) && (fwrite(&numNodes, sizeof(int), 1, output) == 1) && (fwrite(&twoNode, sizeof(int), 1, output) == 1) && (fwrite(&numEdges, sizeof(long int), 1, output) == 1);
+
+  ok = ok && (fwrite(id, sizeof(int), numNodes, output) == (size_t)numNodes);
+  written += (long int)numNodes * sizeof(int);
+
+  ok = ok && padGraph(output, &written, offsetAt);
+  long int kept = 0; // entries kept so far
+  for (int v = 0; ok && (v <= numNodes); v++) {
+    ok = (fwrite(&kept, sizeof(long int), 1, output) == 1);
+    if (v < numNodes)
+      kept += offset[v+1] - first[v];
+  }
+  written += (numNodes + 1L) * sizeof(long int);
+
+  ok = ok && padGraph(output, &written, targetAt);
+  for (int v = 0; ok && (v < numNodes); v++)
+    ok = (fwrite(target + first[v], sizeof(int), offset[v+1] - first[v], output) == (size_t)(offset[v+1] - first[v]));
+  written += numEdges * sizeof(int);
+
+  ok = ok && padGraph(output, &written, weightAt);
+  for (int v = 0; ok && (v < numNodes); v++)
+    ok = (fwrite(weight + first[v], sizeof(unsigned short), offset[v+1] - first[v], output) == (size_t)(offset[v+1] - first[v]));
+  written += numEdges * sizeof(unsigned short);
+
+  free(first);
+  return (fclose(output) == 0) && ok && (written == size);
+}
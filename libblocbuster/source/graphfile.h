@@ -0,0 +1,61 @@
+// -------------------------------------------------------------------------
+// graphfile.h -   Header file for networks saved as compressed sparse row
+//                 (CSR) arrays, ready to be mapped into memory
+//
+// 'bfs --save graph.bbg' writes the network it loaded, after duplicate
+// edges and self-loops are dropped, so bfs and keepHi can map it again
+// later without parsing anything.  The file starts with GRAPH_MAGIC,
+// the number of nodes and whether they are the allele pairs of a
+// TWONODE network (1, 0 or -1 if not known) (ints), and the number of
+// edges (long int).  Four arrays follow, each starting at a multiple of
+// 8 bytes from the start of the file:
+//
+//   id       the node id of each vertex as given in the input (ints)
+//   offset   numNodes + 1 long ints; edges of vertex v are entries
+//            offset[v] to offset[v+1]-1 of target and weight
+//   target   the other endpoint of each edge (ints), higher than v and
+//            in increasing order, so each edge is stored once
+//   weight   weight of each edge, quantised as in weights.h
+//
+// Values are in the byte order of the machine.
+//
+// bfs and keepHi both compile this one copy, from libblocbuster.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _GRAPHFILE_H
+#define _GRAPHFILE_H
+
+#include <stdio.h>
+
+const char GRAPH_MAGIC[8] = {'B', 'B', 'G', 'R', 'A', 'P', 'H', '1'}; // start of graph file
+const int GRAPH_HEAD_BYTES = 24; // magic, nodes, TWONODE flag and edges
+
+struct GraphFile
+{
+  char *data; // mapped file
+  long int size; // bytes in file
+  int numNodes; // number of vertices
+  int twoNode; // 1 if nodes are allele pairs, 0 if not, -1 if not known
+  long int numEdges; // number of edges
+  const int *id; // node id of each vertex
+  const long int *offset; // edges of v are offset[v] to offset[v+1]-1
+  const int *target; // higher endpoint of each edge
+  const unsigned short *weight; // quantised weight of each edge
+};
+
+// map graph file open as input, return 1 if successful, 0 (and rewind)
+// if input is not a graph file and -1 if the file is damaged
+int mapGraph(GraphFile *gf, FILE *input);
+
+// unmap graph file
+void unmapGraph(GraphFile *gf);
+
+// write CSR arrays of an undirected network to a graph file, keeping
+// only entries whose target is higher than their vertex, so arrays with
+// both (i,j) and (j,i) entries may be given; return 1 if successful
+int writeGraph(const char *fileName, int numNodes, int twoNode, const int *id, const long int *offset, const int *target, const unsigned short *weight);
+
+#endif
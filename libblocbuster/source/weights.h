@@ -0,0 +1,68 @@
+// -------------------------------------------------------------------------
+// weights.h -   Header file for 16-bit edge weights
+//
+// CCC values lie between 0 and 1, so an edge weight is stored as a
+// 16-bit fixed-point number, the nearest multiple of 1/65535.  The
+// value read back differs from the original by at most 1/131070, less
+// than the tolerance used when edges are compared with a threshold.
+//
+// A binary edge file written by 'ccc --binary' starts with the 8 bytes
+// of BINARY_MAGIC and the number of nodes (int), followed by one record
+// per edge: source (int), target (int) and quantised weight (unsigned
+// short), 10 bytes in all, in the byte order of the machine.
+//
+// ccc, keepHi and bfs all include this one copy, from libblocbuster.
+//
+// October 2026
+//
+// ------------------------------------------------------------------------
+
+#ifndef _WEIGHTS_H
+#define _WEIGHTS_H
+
+#include <stdio.h>
+#include <string.h>
+
+const double WEIGHT_STEPS = 65535.0; // quantised weight of 1.0
+const char BINARY_MAGIC[8] = {'C', 'C', 'C', 'E', 'D', 'G', 'E', '1'}; // start of binary edge file
+const int BINARY_HEAD_BYTES = 12; // magic and number of nodes
+const int BINARY_EDGE_BYTES = 10; // source, target and weight
+
+inline unsigned short quantiseWeight(double weight) // nearest step, clamped to [0,1]
+{
+  if (weight <= 0.0)
+    return 0;
+  if (weight >= 1.0)
+    return 65535;
+  return (unsigned short)(weight * WEIGHT_STEPS + 0.5);
+}
+
+inline float weightValue(unsigned short q) { return (float)(q / WEIGHT_STEPS); }
+
+inline int writeBinaryHead(FILE *output, int numNodes) // return 1 if written
+{
+  return (fwrite(BINARY_MAGIC, 1, 8, output) == 8) && (fwrite(&numNodes, sizeof(int), 1, output) == 1);
+}
+
+inline int readBinaryHead(FILE *input, int *numNodes) // return 0 (and rewind) if not a binary edge file
+{
+  char magic[8];
+
+  if ((fread(magic, 1, 8, input) == 8) && (memcmp(magic, BINARY_MAGIC, 8) == 0) && (fread(numNodes, sizeof(int), 1, input) == 1))
+    return 1;
+
+  rewind(input);
+  return 0;
+}
+
+inline int writeBinaryEdge(FILE *output, int source, int target, unsigned short weight) // return 1 if written
+{
+  return (fwrite(&source, sizeof(int), 1, output) == 1) && (fwrite(&target, sizeof(int), 1, output) == 1) && (fwrite(&weight, sizeof(unsigned short), 1, output) == 1);
+}
+
+inline int readBinaryEdge(FILE *input, int *source, int *target, unsigned short *weight) // return 0 at end of file
+{
+  return (fread(source, sizeof(int), 1, input) == 1) && (fread(target, sizeof(int), 1, input) == 1) && (fread(weight, sizeof(unsigned short), 1, input) == 1);
+}
+
+#endif